@@ -1,29 +1,160 @@
+#define _GNU_SOURCE     /* copy_file_range, splice */
 #include <stdio.h>      /* dprintf */
-#include <fcntl.h>      /* open */
-#include <unistd.h>     /* read, write, close */
+#include <fcntl.h>      /* open, splice, posix_fadvise */
+#include <unistd.h>     /* read, write, close, copy_file_range */
 #include <stdlib.h>     /* malloc, free, exit */
+#include <string.h>     /* strcmp, strncmp */
+#include <pthread.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>   /* mmap, madvise */
+#include <sys/ioctl.h>  /* ioctl */
+#include <sys/sendfile.h>
+#include <sys/syscall.h> /* __NR_io_uring_setup */
+#include <sys/uio.h>    /* struct iovec */
+#include <errno.h>
+#include <linux/fs.h>   /* FICLONE */
+#ifdef __NR_io_uring_setup
+#include <linux/io_uring.h>
+#endif
 
-#define BUFSIZE 1024
+#define BUF_MIN (128L << 10)
+#define BUF_MAX (8L << 20)
+#define KCOPY_CHUNK (1L << 30)
+#define CP_MAX_THREADS 64
+#define UR_DEPTH 8
+#define UR_BUF_MAX (1L << 20)
+
+#define CP_AUTO 0       /* reflink, then in-kernel copy, then read/write */
+#define CP_RW 1         /* read/write only */
+#define CP_MMAP 2       /* write from a mapping of the source */
+#define CP_PARALLEL 3   /* pread/pwrite ranges from several threads */
+#define CP_URING 4      /* io_uring pipeline of reads and linked writes */
+#define CP_SPARSE 5     /* skip holes and all-zero blocks, read/write */
 
 /**
- * create_buffer - Allocate a 1KB buffer for copying
- * @file_to: destination filename (for error messages)
+ * struct cp_s - State of a copy
+ * @file_from: source filename
+ * @file_to: destination filename
+ * @fd_from: source file descriptor
+ * @fd_to: destination file descriptor
+ * @st: status of the source
+ * @buf: copy buffer
+ * @bufsize: size of @buf
+ * @strategy: CP_AUTO, CP_RW, CP_MMAP, CP_PARALLEL, CP_URING or CP_SPARSE
+ * @threads: number of threads of CP_PARALLEL
+ * @sparse: 0, 1 to keep the holes of the source, 2 to also turn its
+ *          all-zero blocks into holes
+ */
+typedef struct cp_s
+{
+	const char *file_from;
+	const char *file_to;
+	int fd_from;
+	int fd_to;
+	struct stat st;
+	char *buf;
+	size_t bufsize;
+	int strategy;
+	long threads;
+	int sparse;
+} cp_t;
+
+/**
+ * struct cp_range_s - Range of the source copied by one thread
+ * @cp: the copy
+ * @start: offset of the range
+ * @end: offset just past the range
+ * @err: 0, or the exit code of the first error met (98 or 99)
+ * @thread: the thread
+ * @started: nonzero if @thread was created
+ */
+typedef struct cp_range_s
+{
+	const cp_t *cp;
+	off_t start;
+	off_t end;
+	int err;
+	pthread_t thread;
+	int started;
+} cp_range_t;
+
+#ifdef __NR_io_uring_setup
+/* Pointer to a field of a ring mapping, at an offset given by the kernel */
+#define RING_U32(map, off) ((unsigned int *)((map) + (off)))
+
+/**
+ * struct cp_ring_s - io_uring instance, set up with raw system calls
+ * @fd: ring file descriptor
+ * @sq: mapping of the submission ring
+ * @sq_len: size of @sq
+ * @cq: mapping of the completion ring (may be @sq)
+ * @cq_len: size of @cq
+ * @sqes: mapping of the submission queue entries
+ * @sqes_len: size of @sqes
+ * @p: parameters filled in by io_uring_setup()
+ */
+typedef struct cp_ring_s
+{
+	int fd;
+	char *sq;
+	size_t sq_len;
+	char *cq;
+	size_t cq_len;
+	struct io_uring_sqe *sqes;
+	size_t sqes_len;
+	struct io_uring_params p;
+} cp_ring_t;
+
+/**
+ * struct cp_slot_s - Block of the source in flight in the ring
+ * @off: offset of the block
+ * @len: length of the block
+ * @busy: nonzero until the write of the block has completed
+ */
+typedef struct cp_slot_s
+{
+	off_t off;
+	size_t len;
+	int busy;
+} cp_slot_t;
+#endif
+
+/**
+ * buffer_size - Choose the size of the copy buffer
+ * @st: status of the source
  *
- * Return: pointer to allocated buffer
- * Description: On allocation failure, prints an error to STDERR and exits 99.
+ * Return: a multiple of the block size, 1/16th of the file (BUF_MIN to
+ * BUF_MAX), or just enough to read a small file and its end in 2 reads
  */
-static char *create_buffer(const char *file_to)
+static size_t buffer_size(const struct stat *st)
 {
-	char *buf = malloc(BUFSIZE);
+	size_t size = BUF_MIN, blk = st->st_blksize > 0 ? st->st_blksize : 4096;
 
-	if (buf == NULL)
+	while (size < BUF_MAX && (off_t)size < st->st_size / 16)
+		size *= 2;
+	if (S_ISREG(st->st_mode) && st->st_size > 0 &&
+	    (off_t)size > st->st_size)
+		size = st->st_size + 1;
+	return ((size + blk - 1) / blk * blk);
+}
+
+/**
+ * create_buffer - Allocate the copy buffer
+ * @cp: the copy (@cp->st is used, @cp->buf and @cp->bufsize are set)
+ *
+ * Description: On allocation failure, prints an error to STDERR and exits 99.
+ */
+static void create_buffer(cp_t *cp)
+{
+	cp->bufsize = buffer_size(&cp->st);
+	cp->buf = malloc(cp->bufsize);
+	if (cp->buf == NULL)
 	{
-		dprintf(STDERR_FILENO, "Error: Can't write to %s\n", file_to);
+		dprintf(STDERR_FILENO, "Error: Can't write to %s\n",
+			cp->file_to);
 		exit(99);
 	}
-	return (buf);
 }
 
 /**
@@ -69,54 +200,832 @@ static void write_chunk(int fd_to, char *buf, ssize_t r, const char *file_to)
 }
 
 /**
- * copy_rest - Open target, write first block, then copy remaining blocks
+ * reflink - Makes the destination share the blocks of the source
+ * @cp: the copy (the destination is still empty)
+ *
+ * Return: 1 if the whole source was cloned, 0 if the filesystem can't
+ * (different filesystems, or no reflink support)
+ */
+static int reflink(const cp_t *cp)
+{
+	if (!S_ISREG(cp->st.st_mode))
+		return (0);
+	return (ioctl(cp->fd_to, FICLONE, cp->fd_from) == 0);
+}
+
+/**
+ * splice_step - Moves one chunk from @fd_from to @fd_to through a pipe
  * @fd_from: source file descriptor
- * @file_to: destination filename
- * @buf: copy buffer
- * @r_first: number of bytes already read from source
- * @file_from: source filename (for error messages)
+ * @fd_to: destination file descriptor
+ * @pipefd: the pipe
+ * @file_to: destination filename (for error messages)
  *
- * Description: Creates/truncates @file_to with mode 0664. Writes the first
- * block if any, then continues reading/writing in 1KB blocks. On read
- * failure exits 98; on create/write failure exits 99. Closes @fd_to.
+ * Return: bytes moved, 0 at end of file, -1 if splice() can't read
+ * Description: Bytes already in the pipe have left the source, so
+ * failing to move them on is a write error, and exits 99.
  */
-static void copy_rest(int fd_from, const char *file_to, char *buf,
-		      ssize_t r_first, const char *file_from)
+static ssize_t splice_step(int fd_from, int fd_to, int pipefd[2],
+			   const char *file_to)
 {
-	int fd_to;
-	ssize_t r;
+	ssize_t n, w, left;
 
-	fd_to = open(file_to, O_WRONLY | O_CREAT | O_TRUNC, 0664);
-	if (fd_to == -1)
+	n = splice(fd_from, NULL, pipefd[1], NULL, KCOPY_CHUNK,
+		   SPLICE_F_MOVE);
+	for (left = n; left > 0; left -= w)
 	{
-		dprintf(STDERR_FILENO, "Error: Can't write to %s\n", file_to);
-		exit(99);
+		w = splice(pipefd[0], NULL, fd_to, NULL, left, SPLICE_F_MOVE);
+		if (w <= 0)
+		{
+			dprintf(STDERR_FILENO, "Error: Can't write to %s\n",
+				file_to);
+			exit(99);
+		}
+	}
+	return (n);
+}
+
+/**
+ * kernel_copy - Copies the rest of a file without leaving the kernel
+ * @cp: the copy
+ *
+ * Description: Tries copy_file_range(), then sendfile(), then splice()
+ * through a pipe, moving on whenever a call fails for these files. Only
+ * non-empty regular files are copied this way (procfs files claim to be
+ * empty). Both file offsets advance with the data, so the read/write
+ * loop of the caller picks up where the kernel stopped, and reports any
+ * real read or write error.
+ */
+static void kernel_copy(const cp_t *cp)
+{
+	int how, pipefd[2], fd_from = cp->fd_from, fd_to = cp->fd_to;
+	ssize_t n = -1;
+
+	if (!S_ISREG(cp->st.st_mode) || cp->st.st_size == 0)
+		return;
+	for (how = 0; how < 3 && n != 0; how++)
+	{
+		if (how == 2 && pipe(pipefd) == -1)
+			return;
+		do {
+			if (how == 0)
+				n = copy_file_range(fd_from, NULL, fd_to, NULL,
+						    KCOPY_CHUNK, 0);
+			else if (how == 1)
+				n = sendfile(fd_to, fd_from, NULL, KCOPY_CHUNK);
+			else
+				n = splice_step(fd_from, fd_to, pipefd,
+						cp->file_to);
+		} while (n > 0);
+	}
+	if (how == 3)
+	{
+		close(pipefd[0]);
+		close(pipefd[1]);
+	}
+}
+
+/**
+ * mmap_copy - Writes the rest of a file from a mapping of it
+ * @cp: the copy
+ *
+ * Description: Skips the copy into the buffer: page cache pages are
+ * written from directly, with the mapping advised as sequential. If
+ * the source can't be mapped, nothing is done. The source must not be
+ * truncated meanwhile (reading past its end raises SIGBUS).
+ */
+static void mmap_copy(cp_t *cp)
+{
+	off_t pos = lseek(cp->fd_from, 0, SEEK_CUR), len;
+	char *map;
+
+	if (pos == -1 || !S_ISREG(cp->st.st_mode) || cp->st.st_size <= pos)
+		return;
+	map = mmap(NULL, cp->st.st_size, PROT_READ, MAP_SHARED, cp->fd_from,
+		   0);
+	if (map == MAP_FAILED)
+		return;
+	madvise(map, cp->st.st_size, MADV_SEQUENTIAL);
+	for (; pos < cp->st.st_size; pos += len)
+	{
+		len = cp->st.st_size - pos < BUF_MAX ?
+			cp->st.st_size - pos : BUF_MAX;
+		write_chunk(cp->fd_to, map + pos, len, cp->file_to);
+	}
+	munmap(map, cp->st.st_size);
+	lseek(cp->fd_from, pos, SEEK_SET);
+}
+
+/**
+ * copy_error - Reports a read or write error and exits
+ * @cp: the copy (the destination is open)
+ * @code: 98 for a read error, 99 for a write error
+ */
+static void copy_error(const cp_t *cp, int code)
+{
+	if (code == 98)
+		dprintf(STDERR_FILENO, "Error: Can't read from file %s\n",
+			cp->file_from);
+	else
+		dprintf(STDERR_FILENO, "Error: Can't write to %s\n",
+			cp->file_to);
+	close_fd(cp->fd_to);
+	exit(code);
+}
+
+/**
+ * to_regular - Tells whether the destination is a regular file
+ * @cp: the copy (the destination is open)
+ *
+ * Description: pwrite() and offset I/O fail on pipes, sockets and
+ * terminals, so the engines that write at file offsets check this first.
+ * Return: 1 if it is, 0 otherwise
+ */
+static int to_regular(const cp_t *cp)
+{
+	struct stat st_to;
+
+	return (fstat(cp->fd_to, &st_to) == 0 && S_ISREG(st_to.st_mode));
+}
+
+/**
+ * range_copy - Copies a range of the source to the same offsets
+ * @arg: the cp_range_t of the thread
+ *
+ * Description: Each thread reads into a buffer of its own. A short file
+ * (one truncated meanwhile) ends the range early.
+ * Return: NULL
+ */
+static void *range_copy(void *arg)
+{
+	cp_range_t *rg = arg;
+	const cp_t *cp = rg->cp;
+	char *buf = malloc(cp->bufsize);
+	off_t pos;
+	ssize_t r = 0, w, done;
+
+	if (buf == NULL)
+		rg->err = 99;
+	for (pos = rg->start; buf != NULL && pos < rg->end; pos += r)
+	{
+		r = rg->end - pos < (off_t)cp->bufsize ?
+			rg->end - pos : (off_t)cp->bufsize;
+		r = pread(cp->fd_from, buf, r, pos);
+		if (r <= 0)
+		{
+			rg->err = r == -1 ? 98 : 0;
+			break;
+		}
+		for (done = 0; done < r && rg->err == 0; done += w)
+		{
+			w = pwrite(cp->fd_to, buf + done, r - done, pos + done);
+			if (w == -1)
+				rg->err = 99;
+		}
+		if (rg->err != 0)
+			break;
+	}
+	free(buf);
+	return (NULL);
+}
+
+/**
+ * split_ranges - Splits the rest of the source among the threads
+ * @cp: the copy
+ * @rg: receives the ranges, up to @cp->threads of them
+ * @pos: offset the copy starts at
+ * @size: size of the source
+ *
+ * Description: Ranges are made of whole buffers, and hold at least
+ * BUF_MAX bytes each, so a small file doesn't start idle threads.
+ * Return: number of ranges
+ */
+static long split_ranges(const cp_t *cp, cp_range_t *rg, off_t pos,
+			 off_t size)
+{
+	off_t chunk;
+	long i, n = cp->threads;
+
+	if (n > (size - pos + BUF_MAX - 1) / BUF_MAX)
+		n = (size - pos + BUF_MAX - 1) / BUF_MAX;
+	chunk = (size - pos + n - 1) / n;
+	chunk = (chunk + cp->bufsize - 1) / cp->bufsize * cp->bufsize;
+	for (i = 0; i < n; i++)
+	{
+		rg[i].cp = cp;
+		rg[i].start = pos + i * chunk < size ? pos + i * chunk : size;
+		rg[i].end = size - rg[i].start > chunk ?
+			rg[i].start + chunk : size;
+		rg[i].err = 0;
+	}
+	return (n);
+}
+
+/**
+ * parallel_copy - Copies the rest of a file from several threads
+ * @cp: the copy
+ *
+ * Description: The destination is preallocated, then the ranges of
+ * split_ranges() are copied concurrently with pread()/pwrite(). A range
+ * whose thread can't be created is copied by the caller. Errors exit 98
+ * (read) or 99 (write) once every thread is done. Only a regular
+ * destination is written this way.
+ */
+static void parallel_copy(cp_t *cp)
+{
+	cp_range_t rg[CP_MAX_THREADS];
+	off_t pos = lseek(cp->fd_from, 0, SEEK_CUR), size = cp->st.st_size;
+	long i, n;
+	int err = 0;
+
+	if (pos == -1 || !S_ISREG(cp->st.st_mode) || size <= pos ||
+	    !to_regular(cp))
+		return;
+	n = split_ranges(cp, rg, pos, size);
+	fallocate(cp->fd_to, 0, 0, size);
+	for (i = 0; i < n; i++)
+	{
+		rg[i].started = pthread_create(&rg[i].thread, NULL, range_copy,
+					       &rg[i]) == 0;
+		if (!rg[i].started)
+			range_copy(&rg[i]);
+	}
+	for (i = 0; i < n; i++)
+	{
+		if (rg[i].started)
+			pthread_join(rg[i].thread, NULL);
+		if (err == 0)
+			err = rg[i].err;
+	}
+	if (err != 0)
+		copy_error(cp, err);
+	lseek(cp->fd_from, size, SEEK_SET);
+	lseek(cp->fd_to, size, SEEK_SET);
+}
+
+#ifdef __NR_io_uring_setup
+/**
+ * ring_close - Tears down a ring
+ * @r: the ring
+ */
+static void ring_close(cp_ring_t *r)
+{
+	if (r->sqes != NULL && r->sqes != MAP_FAILED)
+		munmap(r->sqes, r->sqes_len);
+	if (r->cq != NULL && r->cq != MAP_FAILED && r->cq != r->sq)
+		munmap(r->cq, r->cq_len);
+	if (r->sq != NULL && r->sq != MAP_FAILED)
+		munmap(r->sq, r->sq_len);
+	close(r->fd);
+}
+
+/**
+ * ring_open - Sets up a ring and maps its queues
+ * @r: receives the ring
+ * @entries: number of submission queue entries
+ *
+ * Return: 1 on success, 0 if io_uring is unavailable
+ */
+static int ring_open(cp_ring_t *r, unsigned int entries)
+{
+	memset(r, 0, sizeof(*r));
+	r->fd = syscall(__NR_io_uring_setup, entries, &r->p);
+	if (r->fd == -1)
+		return (0);
+	r->sq_len = r->p.sq_off.array + r->p.sq_entries * sizeof(unsigned int);
+	r->cq_len = r->p.cq_off.cqes +
+		r->p.cq_entries * sizeof(struct io_uring_cqe);
+	if ((r->p.features & IORING_FEAT_SINGLE_MMAP) && r->cq_len > r->sq_len)
+		r->sq_len = r->cq_len;
+	r->sq = mmap(NULL, r->sq_len, PROT_READ | PROT_WRITE,
+		     MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+	r->cq = r->sq;
+	if (r->sq != MAP_FAILED && !(r->p.features & IORING_FEAT_SINGLE_MMAP))
+		r->cq = mmap(NULL, r->cq_len, PROT_READ | PROT_WRITE,
+			     MAP_SHARED | MAP_POPULATE, r->fd,
+			     IORING_OFF_CQ_RING);
+	r->sqes_len = r->p.sq_entries * sizeof(struct io_uring_sqe);
+	if (r->sq != MAP_FAILED && r->cq != MAP_FAILED)
+		r->sqes = mmap(NULL, r->sqes_len, PROT_READ | PROT_WRITE,
+			       MAP_SHARED | MAP_POPULATE, r->fd,
+			       IORING_OFF_SQES);
+	if (r->sq == MAP_FAILED || r->cq == MAP_FAILED ||
+	    r->sqes == MAP_FAILED)
+	{
+		ring_close(r);
+		return (0);
+	}
+	return (1);
+}
+
+/**
+ * ring_push - Queues a fixed-buffer read or write of a slot
+ * @r: the ring
+ * @op: IORING_OP_READ_FIXED or IORING_OP_WRITE_FIXED
+ * @fd: file descriptor
+ * @buf: registered buffer of the slot
+ * @s: index of the slot (also its registered buffer index)
+ * @sl: the slot
+ */
+static void ring_push(cp_ring_t *r, int op, int fd, char *buf,
+		      unsigned int s, const cp_slot_t *sl)
+{
+	unsigned int tail = *RING_U32(r->sq, r->p.sq_off.tail), idx;
+	struct io_uring_sqe *sqe;
+
+	idx = tail & *RING_U32(r->sq, r->p.sq_off.ring_mask);
+	sqe = &r->sqes[idx];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = op;
+	sqe->fd = fd;
+	sqe->flags = op == IORING_OP_READ_FIXED ? IOSQE_IO_LINK : 0;
+	sqe->addr = (unsigned long int)buf;
+	sqe->len = sl->len;
+	sqe->off = sl->off;
+	sqe->buf_index = s;
+	sqe->user_data = s * 2 + (op == IORING_OP_WRITE_FIXED);
+	RING_U32(r->sq, r->p.sq_off.array)[idx] = idx;
+	__atomic_store_n(RING_U32(r->sq, r->p.sq_off.tail), tail + 1,
+			 __ATOMIC_RELEASE);
+}
+
+/**
+ * pwrite_full - Writes a whole block at an offset
+ * @cp: the copy
+ * @buf: the block
+ * @len: its length
+ * @off: its offset
+ *
+ * Description: On write failure, exits 99.
+ */
+static void pwrite_full(const cp_t *cp, const char *buf, size_t len,
+			off_t off)
+{
+	ssize_t w;
+
+	for (; len > 0; len -= w, buf += w, off += w)
+	{
+		w = pwrite(cp->fd_to, buf, len, off);
+		if (w == -1)
+			copy_error(cp, 99);
+	}
+}
+
+/**
+ * ring_reap - Handles the completions available in the ring
+ * @r: the ring
+ * @cp: the copy
+ * @slots: the slots
+ * @bufs: the registered buffers, one per slot
+ * @end: end of the source, lowered if it turns out to be shorter
+ *
+ * Description: A short read fails its link, so the write of the block
+ * is cancelled; the bytes that were read are written here instead. A
+ * short write is completed here too.
+ * Return: number of slots freed
+ */
+static unsigned int ring_reap(cp_ring_t *r, const cp_t *cp,
+			      cp_slot_t *slots, char *bufs, off_t *end)
+{
+	unsigned int head = *RING_U32(r->cq, r->p.cq_off.head), tail, s;
+	unsigned int mask = *RING_U32(r->cq, r->p.cq_off.ring_mask), n = 0;
+	struct io_uring_cqe *cqe;
+	size_t bs = cp->bufsize < UR_BUF_MAX ? cp->bufsize : UR_BUF_MAX;
+
+	tail = __atomic_load_n(RING_U32(r->cq, r->p.cq_off.tail),
+			       __ATOMIC_ACQUIRE);
+	for (; head != tail; head++)
+	{
+		cqe = (struct io_uring_cqe *)(r->cq + r->p.cq_off.cqes) +
+			(head & mask);
+		s = cqe->user_data / 2;
+		if (cqe->user_data % 2 == 0 && cqe->res < 0)
+			copy_error(cp, 98);
+		if (cqe->user_data % 2 == 0 && (size_t)cqe->res < slots[s].len)
+		{
+			pwrite_full(cp, bufs + s * bs, cqe->res, slots[s].off);
+			if (slots[s].off + cqe->res < *end)
+				*end = slots[s].off + cqe->res;
+		}
+		if (cqe->user_data % 2 == 0)
+			continue;
+		if (cqe->res < 0 && cqe->res != -ECANCELED)
+			copy_error(cp, 99);
+		if (cqe->res >= 0 && (size_t)cqe->res < slots[s].len)
+			pwrite_full(cp, bufs + s * bs + cqe->res,
+				    slots[s].len - cqe->res,
+				    slots[s].off + cqe->res);
+		slots[s].busy = 0;
+		n++;
+	}
+	__atomic_store_n(RING_U32(r->cq, r->p.cq_off.head), head,
+			 __ATOMIC_RELEASE);
+	return (n);
+}
+
+/**
+ * ring_run - Keeps UR_DEPTH blocks in flight until the source is copied
+ * @r: the ring (with the buffers registered)
+ * @cp: the copy
+ * @bufs: the registered buffers, one per slot
+ * @pos: offset to copy from
+ * @end: end of the source
+ *
+ * Description: Each block is a read followed by a write linked to it,
+ * so the write starts as soon as the read completes, without a round
+ * trip through user space.
+ * Return: offset the copy ended at
+ */
+static off_t ring_run(cp_ring_t *r, const cp_t *cp, char *bufs, off_t pos,
+		      off_t end)
+{
+	cp_slot_t slots[UR_DEPTH];
+	size_t bs = cp->bufsize < UR_BUF_MAX ? cp->bufsize : UR_BUF_MAX;
+	unsigned int s, busy = 0, submit = 0;
+	long n;
+
+	memset(slots, 0, sizeof(slots));
+	while (pos < end || busy > 0)
+	{
+		for (s = 0; s < UR_DEPTH && pos < end; s++)
+		{
+			if (slots[s].busy)
+				continue;
+			slots[s].off = pos;
+			slots[s].len = bs;
+			if (end - pos < (off_t)bs)
+				slots[s].len = end - pos;
+			slots[s].busy = 1;
+			ring_push(r, IORING_OP_READ_FIXED, cp->fd_from,
+				  bufs + s * bs, s, &slots[s]);
+			ring_push(r, IORING_OP_WRITE_FIXED, cp->fd_to,
+				  bufs + s * bs, s, &slots[s]);
+			pos += slots[s].len;
+			busy++;
+			submit += 2;
+		}
+		n = syscall(__NR_io_uring_enter, r->fd, submit, 1,
+			    IORING_ENTER_GETEVENTS, NULL, 0);
+		if (n == -1 && errno != EINTR)
+			copy_error(cp, 99);
+		if (n > 0)
+			submit -= n;
+		busy -= ring_reap(r, cp, slots, bufs, &end);
+	}
+	return (end);
+}
+
+/**
+ * uring_copy - Copies the rest of a file through io_uring
+ * @cp: the copy
+ *
+ * Description: UR_DEPTH buffers of up to UR_BUF_MAX bytes are registered
+ * with the ring, so the kernel doesn't map them for every request. If
+ * io_uring is unavailable (old kernel, disabled, seccomp) or the
+ * destination is not a regular file, nothing is done.
+ */
+static void uring_copy(cp_t *cp)
+{
+	off_t pos = lseek(cp->fd_from, 0, SEEK_CUR), end = cp->st.st_size;
+	size_t bs = cp->bufsize < UR_BUF_MAX ? cp->bufsize : UR_BUF_MAX;
+	struct iovec iov[UR_DEPTH];
+	cp_ring_t r;
+	char *bufs;
+	int s;
+
+	if (pos == -1 || !S_ISREG(cp->st.st_mode) || end <= pos ||
+	    !to_regular(cp))
+		return;
+	bufs = malloc(bs * UR_DEPTH);
+	if (bufs == NULL || !ring_open(&r, 2 * UR_DEPTH))
+	{
+		free(bufs);
+		return;
+	}
+	for (s = 0; s < UR_DEPTH; s++)
+	{
+		iov[s].iov_base = bufs + s * bs;
+		iov[s].iov_len = bs;
+	}
+	if (syscall(__NR_io_uring_register, r.fd, IORING_REGISTER_BUFFERS,
+		    iov, UR_DEPTH) == 0)
+	{
+		end = ring_run(&r, cp, bufs, pos, end);
+		lseek(cp->fd_from, end, SEEK_SET);
+		lseek(cp->fd_to, end, SEEK_SET);
+	}
+	ring_close(&r);
+	free(bufs);
+}
+#else
+/**
+ * uring_copy - Stands in for the io_uring engine on systems without it
+ * @cp: the copy
+ *
+ * Description: Does nothing, the read/write loop copies the file.
+ */
+static void uring_copy(cp_t *cp)
+{
+	(void)cp;
+}
+#endif
+
+/**
+ * is_zero - Tells whether a block holds only zero bytes
+ * @buf: the block (word-aligned)
+ * @len: size of @buf
+ *
+ * Description: Words are OR-ed together 16 at a time, a loop the
+ * compiler vectorizes; a nonzero group ends the scan.
+ * Return: 1 if all bytes of @buf are zero, 0 otherwise
+ */
+static int is_zero(const char *buf, size_t len)
+{
+	const unsigned long int *w = (const unsigned long int *)buf;
+	unsigned long int acc;
+	size_t n = len / sizeof(*w), i, j;
+
+	for (i = 0; i < n; i += 16)
+	{
+		acc = 0;
+		for (j = i; j < i + 16 && j < n; j++)
+			acc |= w[j];
+		if (acc != 0)
+			return (0);
+	}
+	for (i = n * sizeof(*w); i < len; i++)
+		if (buf[i] != 0)
+			return (0);
+	return (1);
+}
+
+/**
+ * write_holes - Writes a block, leaving holes for its all-zero pieces
+ * @cp: the copy
+ * @buf: the block
+ * @len: size of @buf
+ *
+ * Description: The all-zero pieces of st_blksize bytes are not written:
+ * the destination offset is moved past them. On write failure exits 99.
+ */
+static void write_holes(const cp_t *cp, char *buf, size_t len)
+{
+	size_t blk = cp->st.st_blksize > 0 ? (size_t)cp->st.st_blksize : 4096;
+	size_t i, n, run = 0;
+
+	for (i = 0; i < len; i += n)
+	{
+		n = len - i < blk ? len - i : blk;
+		if (!is_zero(buf + i, n))
+		{
+			run += n;
+			continue;
+		}
+		write_chunk(cp->fd_to, buf + i - run, run, cp->file_to);
+		run = 0;
+		if (lseek(cp->fd_to, n, SEEK_CUR) == -1)
+			copy_error(cp, 99);
+	}
+	write_chunk(cp->fd_to, buf + len - run, run, cp->file_to);
+}
+
+/**
+ * write_block - Writes a block read from the source to the destination
+ * @cp: the copy
+ * @buf: the block
+ * @len: size of @buf
+ *
+ * Description: With @cp->sparse == 2, the block goes through
+ * write_holes(). On write failure exits 99.
+ */
+static void write_block(const cp_t *cp, char *buf, size_t len)
+{
+	if (cp->sparse == 2)
+		write_holes(cp, buf, len);
+	else
+		write_chunk(cp->fd_to, buf, len, cp->file_to);
+}
+
+/**
+ * segment_copy - Copies @len bytes at the current offsets of both files
+ * @cp: the copy
+ * @len: number of bytes
+ *
+ * Description: With CP_AUTO the bytes are copied in the kernel when it
+ * can; the rest goes through @cp->buf. Stops early if the source shrank.
+ */
+static void segment_copy(const cp_t *cp, off_t len)
+{
+	ssize_t n;
+
+	while (len > 0 && cp->strategy == CP_AUTO)
+	{
+		n = copy_file_range(cp->fd_from, NULL, cp->fd_to, NULL,
+				    len < KCOPY_CHUNK ? len : KCOPY_CHUNK, 0);
+		if (n <= 0)
+			break;
+		len -= n;
 	}
+	while (len > 0)
+	{
+		n = read(cp->fd_from, cp->buf,
+			 (size_t)len < cp->bufsize ? (size_t)len : cp->bufsize);
+		if (n == -1)
+			copy_error(cp, 98);
+		if (n == 0)
+			break;
+		write_block(cp, cp->buf, n);
+		len -= n;
+	}
+}
+
+/**
+ * sparse_copy - Copies only the data segments of a sparse source
+ * @cp: the copy (both files are regular)
+ * @pos: offset both files are at, past the first block
+ *
+ * Description: The data segments are found with SEEK_DATA/SEEK_HOLE;
+ * the destination offset is moved over the holes between them, so the
+ * destination gets the same holes and the copy costs in proportion to
+ * the allocated data. A trailing hole is left to the final ftruncate of
+ * copy_rest(). If the filesystem cannot seek to data, the rest of the
+ * file is left to the caller.
+ */
+static void sparse_copy(const cp_t *cp, off_t pos)
+{
+	off_t data, hole, size = cp->st.st_size;
+
+	while (pos < size)
+	{
+		data = lseek(cp->fd_from, pos, SEEK_DATA);
+		if (data == -1 && errno != ENXIO)
+		{
+			if (lseek(cp->fd_from, pos, SEEK_SET) == -1)
+				copy_error(cp, 98);
+			return;
+		}
+		if (data == -1 || data > size)
+			data = size;
+		hole = data < size ? lseek(cp->fd_from, data, SEEK_HOLE) : size;
+		if (hole == -1 || hole > size)
+			hole = size;
+		if (lseek(cp->fd_from, data, SEEK_SET) == -1)
+			copy_error(cp, 98);
+		if (lseek(cp->fd_to, data, SEEK_SET) == -1)
+			copy_error(cp, 99);
+		segment_copy(cp, hole - data);
+		pos = hole;
+	}
+}
+
+/**
+ * run_engine - Copies the data after the first block with the strategy
+ * @cp: the copy
+ *
+ * Description: With CP_AUTO, the data is copied in the kernel when it
+ * can be; with CP_MMAP, it is written from a mapping of the source; with
+ * CP_PARALLEL, by several threads; with CP_URING, through io_uring.
+ */
+static void run_engine(cp_t *cp)
+{
+	if (cp->strategy == CP_AUTO)
+		kernel_copy(cp);
+	else if (cp->strategy == CP_MMAP)
+		mmap_copy(cp);
+	else if (cp->strategy == CP_PARALLEL)
+		parallel_copy(cp);
+	else if (cp->strategy == CP_URING)
+		uring_copy(cp);
+}
 
-	if (r_first > 0)
-		write_chunk(fd_to, buf, r_first, file_to);
+/**
+ * copy_loop - Reads/writes the rest of the source in blocks
+ * @cp: the copy
+ *
+ * Description: Each engine leaves both file offsets past the bytes it
+ * copied, or untouched if it can't be used, so this loop copies what
+ * the source grew by, or all of it. In sparse mode, the destination is
+ * then cut at its offset, which keeps a trailing hole. On read failure
+ * exits 98; on write failure exits 99.
+ */
+static void copy_loop(const cp_t *cp)
+{
+	ssize_t r;
 
-	r = read(fd_from, buf, BUFSIZE);
+	r = read(cp->fd_from, cp->buf, cp->bufsize);
 	while (r > 0)
 	{
-		write_chunk(fd_to, buf, r, file_to);
-		r = read(fd_from, buf, BUFSIZE);
+		write_block(cp, cp->buf, r);
+		r = read(cp->fd_from, cp->buf, cp->bufsize);
 	}
 	if (r == -1)
+		copy_error(cp, 98);
+	if (cp->sparse &&
+	    ftruncate(cp->fd_to, lseek(cp->fd_to, 0, SEEK_CUR)) == -1)
+		copy_error(cp, 99);
+}
+
+/**
+ * copy_rest - Open target, write first block, then copy remaining blocks
+ * @cp: the copy (@cp->buf holds the first block)
+ * @r_first: number of bytes already read from source
+ *
+ * Description: Creates/truncates @cp->file_to with mode 0664. With
+ * CP_AUTO, a reflink is tried first. To a regular file, CP_AUTO and
+ * CP_SPARSE keep the holes of a regular source with sparse_copy(); the
+ * first block, read before the holes could be looked for, gets a hole
+ * for each all-zero piece instead. CP_SPARSE also turns all-zero blocks
+ * into holes. When the destination is the source, it was just
+ * truncated: only the first block is left, and it is written back with
+ * read/write alone. The rest goes through run_engine() and copy_loop().
+ * On create failure exits 99. Closes the destination.
+ */
+static void copy_rest(cp_t *cp, ssize_t r_first)
+{
+	struct stat st_to;
+
+	cp->fd_to = open(cp->file_to, O_WRONLY | O_CREAT | O_TRUNC, 0664);
+	if (cp->fd_to == -1)
 	{
-		dprintf(STDERR_FILENO, "Error: Can't read from file %s\n",
-			file_from);
-		close_fd(fd_to);
-		exit(98);
+		dprintf(STDERR_FILENO, "Error: Can't write to %s\n",
+			cp->file_to);
+		exit(99);
+	}
+
+	if (fstat(cp->fd_to, &st_to) == -1)
+		st_to.st_mode = 0;
+	else if (st_to.st_dev == cp->st.st_dev && st_to.st_ino == cp->st.st_ino)
+		cp->strategy = CP_RW;
+	if (cp->strategy == CP_AUTO && reflink(cp))
+	{
+		close_fd(cp->fd_to);
+		return;
 	}
+	if ((cp->strategy == CP_AUTO || cp->strategy == CP_SPARSE) &&
+	    S_ISREG(st_to.st_mode))
+		cp->sparse = cp->strategy == CP_SPARSE ? 2 : 1;
+	if (cp->sparse)
+		write_holes(cp, cp->buf, r_first);
+	else if (r_first > 0)
+		write_block(cp, cp->buf, r_first);
+	if (cp->sparse && S_ISREG(cp->st.st_mode))
+		sparse_copy(cp, r_first);
+	run_engine(cp);
+	copy_loop(cp);
 
-	close_fd(fd_to);
+	close_fd(cp->fd_to);
+}
+
+/**
+ * parse_strategy - Reads the optional --strategy=NAME argument
+ * @cp: the copy (@cp->threads is set for CP_PARALLEL)
+ * @argc: argument count
+ * @argv: argument vector
+ *
+ * Description: parallel takes an optional thread count, parallel:N;
+ * it defaults to the number of online CPUs.
+ * Return: the CP_ strategy, or -1 if the arguments are not
+ * [--strategy=auto|rw|mmap|parallel[:N]|uring|sparse] file_from file_to
+ */
+static int parse_strategy(cp_t *cp, int argc, char *argv[])
+{
+	const char *name;
+	char *end;
+
+	if (argc == 3)
+		return (CP_AUTO);
+	if (argc != 4 || strncmp(argv[1], "--strategy=", 11) != 0)
+		return (-1);
+	name = argv[1] + 11;
+	if (strcmp(name, "auto") == 0)
+		return (CP_AUTO);
+	if (strcmp(name, "rw") == 0)
+		return (CP_RW);
+	if (strcmp(name, "mmap") == 0)
+		return (CP_MMAP);
+	if (strcmp(name, "uring") == 0)
+		return (CP_URING);
+	if (strcmp(name, "sparse") == 0)
+		return (CP_SPARSE);
+	if (strncmp(name, "parallel", 8) != 0)
+		return (-1);
+	cp->threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (name[8] == ':')
+		cp->threads = strtol(name + 9, &end, 10);
+	else if (name[8] != '\0')
+		return (-1);
+	if ((name[8] == ':' && (*end != '\0' || end == name + 9)) ||
+	    cp->threads < 1)
+		return (-1);
+	if (cp->threads > CP_MAX_THREADS)
+		cp->threads = CP_MAX_THREADS;
+	return (CP_PARALLEL);
 }
 
 /**
  * main - Copy the content of a file to another file
  * @argc: argument count
- * @argv: argument vector (argv[1]=file_from, argv[2]=file_to)
+ * @argv: argument vector (argv[1]=file_from, argv[2]=file_to, or
+ *        argv[1]=--strategy=NAME before them)
  *
  * Return: 0 on success
  * Description: Exits with 97 (usage), 98 (read), 99 (write/create),
@@ -125,40 +1034,43 @@ static void copy_rest(int fd_from, const char *file_to, char *buf,
  */
 int main(int argc, char *argv[])
 {
-	int fd_from;
+	cp_t cp;
 	ssize_t r_first;
-	char *buf;
 
-	if (argc != 3)
+	cp.threads = 1;
+	cp.sparse = 0;
+	cp.strategy = parse_strategy(&cp, argc, argv);
+	if (cp.strategy == -1)
 	{
 		dprintf(STDERR_FILENO, "Usage: cp file_from file_to\n");
 		exit(97);
 	}
+	cp.file_from = argv[argc - 2];
+	cp.file_to = argv[argc - 1];
 
-	buf = create_buffer(argv[2]);
-
-	fd_from = open(argv[1], O_RDONLY);
-	if (fd_from == -1)
+	cp.fd_from = open(cp.file_from, O_RDONLY);
+	if (cp.fd_from == -1 || fstat(cp.fd_from, &cp.st) == -1)
 	{
 		dprintf(STDERR_FILENO, "Error: Can't read from file %s\n",
-			argv[1]);
-		free(buf);
+			cp.file_from);
 		exit(98);
 	}
+	posix_fadvise(cp.fd_from, 0, 0, POSIX_FADV_SEQUENTIAL);
+	create_buffer(&cp);
 
-	r_first = read(fd_from, buf, BUFSIZE);
+	r_first = read(cp.fd_from, cp.buf, cp.bufsize);
 	if (r_first == -1)
 	{
 		dprintf(STDERR_FILENO, "Error: Can't read from file %s\n",
-			argv[1]);
-		free(buf);
-		close_fd(fd_from);
+			cp.file_from);
+		free(cp.buf);
+		close_fd(cp.fd_from);
 		exit(98);
 	}
 
-	copy_rest(fd_from, argv[2], buf, r_first, argv[1]);
+	copy_rest(&cp, r_first);
 
-	free(buf);
-	close_fd(fd_from);
+	free(cp.buf);
+	close_fd(cp.fd_from);
 	return (0);
 }
@@ -0,0 +1,59 @@
+#!/bin/bash
+# cp_bench.sh - Throughput of each 3-cp strategy across file sizes
+#
+# Usage: ./cp_bench.sh [size...]     (sizes as understood by head -c,
+#                                     default: 4K 1M 64M 1G; try 10G)
+# Env:   CP (default ../3-cp, built from ../3-cp.c if missing),
+#        DIR (scratch directory, default: a new one under /tmp),
+#        RUNS (runs per strategy and size, default 3; the best is kept),
+#        STRATEGIES (default: "rw mmap parallel uring auto")
+#
+# Source pages are in the page cache (the file was just written), so
+# this measures the copy path, not the disk. Run as root to drop caches
+# between runs instead (COLD=1).
+
+CP=${CP:-$(dirname "$0")/../3-cp}
+if [ -z "$DIR" ]; then
+	DIR=$(mktemp -d /tmp/cp_bench.XXXXXX) || exit 1
+	OWN_DIR=1
+fi
+RUNS=${RUNS:-3}
+STRATEGIES=${STRATEGIES:-"rw mmap parallel uring auto"}
+SIZES=${*:-4K 1M 64M 1G}
+
+if [ ! -x "$CP" ]; then
+	gcc -O2 -Wall -Werror -Wextra -pedantic -std=gnu89 \
+		"$(dirname "$0")/../3-cp.c" -o "$CP" -pthread || exit 1
+fi
+
+to_bytes()
+{
+	numfmt --from=iec "$1"
+}
+
+printf "%-8s" size
+for s in $STRATEGIES; do printf "%14s" "$s"; done
+echo
+for size in $SIZES; do
+	head -c "$size" /dev/urandom > "$DIR/src" || exit 1
+	bytes=$(to_bytes "$size")
+	printf "%-8s" "$size"
+	for s in $STRATEGIES; do
+		best=0
+		for r in $(seq "$RUNS"); do
+			rm -f "$DIR/dst"
+			[ "$COLD" = 1 ] && sync && echo 3 > /proc/sys/vm/drop_caches
+			t0=$(date +%s%N)
+			"$CP" --strategy="$s" "$DIR/src" "$DIR/dst" || exit 1
+			t1=$(date +%s%N)
+			ns=$((t1 - t0 > 0 ? t1 - t0 : 1))
+			mbs=$((bytes * 1000 / ns))
+			[ "$mbs" -gt "$best" ] && best=$mbs
+		done
+		cmp -s "$DIR/src" "$DIR/dst" || { echo "$s: bad copy"; exit 1; }
+		printf "%9s MB/s" "$best"
+	done
+	echo
+done
+rm -f "$DIR/src" "$DIR/dst"
+[ -n "$OWN_DIR" ] && rmdir "$DIR"
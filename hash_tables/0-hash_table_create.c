@@ -8,12 +8,70 @@
  *         or NULL if something went wrong
  */
 hash_table_t *hash_table_create(unsigned long int size)
+{
+	return (hash_table_create_opts(size, NULL));
+}
+
+/**
+ * opts_apply - Sets the options of a new hash table
+ * @ht: The table, whose array is set up
+ * @opts: Options, or NULL for the defaults of hash_table_create()
+ *
+ * Return: 1 on success, 0 if the arena or the counters can't be
+ *         allocated
+ */
+static int opts_apply(hash_table_t *ht, const hash_opts_t *opts)
+{
+	ht->old_size = 0;
+	ht->old_array = NULL;
+	ht->rehash_pos = 0;
+	ht->removed = NULL;
+	ht->removed_count = 0;
+	ht->bloom = NULL;
+	ht->hf = opts != NULL && opts->hf != NULL ? opts->hf : &hash_func_djb2;
+	ht->seed = opts != NULL ? opts->seed : 0;
+	ht->index_mode = opts != NULL ? opts->index_mode : HT_INDEX_MOD;
+	ht->inline_strings = opts != NULL ? opts->inline_strings : 0;
+	ht->pool = opts != NULL ? opts->pool : NULL;
+	ht->incremental = opts != NULL ? opts->incremental : 0;
+	ht->defer_free = opts != NULL ? opts->defer_free : 0;
+	ht->arena = NULL;
+	ht->counters = NULL;
+	if (opts != NULL && opts->use_arena)
+	{
+		ht->arena = hash_arena_create(opts->slab_size);
+		if (ht->arena == NULL)
+			return (0);
+	}
+	if (opts != NULL && opts->counters)
+	{
+		ht->counters = calloc(1, sizeof(hash_counters_t));
+		if (ht->counters == NULL)
+			return (0);
+	}
+	return (1);
+}
+
+/**
+ * hash_table_create_opts - Creates a hash table with chosen options
+ * @size: The size of the array
+ * @opts: Options, or NULL for the defaults of hash_table_create()
+ *
+ * Return: A pointer to the newly created hash table,
+ *         or NULL if something went wrong
+ */
+hash_table_t *hash_table_create_opts(unsigned long int size,
+				     const hash_opts_t *opts)
 {
 	hash_table_t *ht;
 	unsigned long int i;
 
 	if (size == 0)
 		return (NULL);
+	if (opts != NULL && opts->index_mode == HT_INDEX_MASK)
+		size = hash_pow2(size);
+	if (size == 0) /* too large to round up to a power of two */
+		return (NULL);
 
 	ht = malloc(sizeof(hash_table_t));
 	if (ht == NULL)
@@ -29,6 +87,12 @@ hash_table_t *hash_table_create(unsigned long int size)
 
 	for (i = 0; i < size; i++)
 		ht->array[i] = NULL;
+	ht->count = 0;
 
+	if (!opts_apply(ht, opts))
+	{
+		hash_table_delete(ht);
+		return (NULL);
+	}
 	return (ht);
 }
@@ -4,18 +4,30 @@
  * shash_node_create - Creates a new sorted hash node
  * @key: Key string (must be non-empty)
  * @value: Value string (will be duplicated)
+ * @level: Number of skip list levels above the sorted list for the node
+ * @pool: Pool to intern the key in, or NULL to duplicate it
  *
  * Return: Pointer to new node or NULL on failure
  */
-static shash_node_t *shash_node_create(const char *key, const char *value)
+static shash_node_t *shash_node_create(const char *key, const char *value,
+				       int level, str_pool_t *pool)
 {
 	shash_node_t *node;
+	int i;
 
-	node = malloc(sizeof(shash_node_t));
+	/* the skip list pointers are allocated right behind the node */
+	node = malloc(sizeof(shash_node_t) + sizeof(shash_node_t *) * level);
 	if (node == NULL)
 		return (NULL);
+	node->slevel = level;
+	node->sfwd = (shash_node_t **)(node + 1);
+	for (i = 0; i < level; i++)
+		node->sfwd[i] = NULL;
 
-	node->key = strdup(key);
+	if (pool != NULL)
+		node->key = (char *)str_pool_intern(pool, key, strlen(key));
+	else
+		node->key = strdup(key);
 	if (node->key == NULL)
 	{
 		free(node);
@@ -25,7 +37,10 @@ static shash_node_t *shash_node_create(const char *key, const char *value)
 	node->value = strdup(value);
 	if (node->value == NULL)
 	{
-		free(node->key);
+		if (pool != NULL)
+			str_pool_release(pool, node->key);
+		else
+			free(node->key);
 		free(node);
 		return (NULL);
 	}
@@ -66,53 +81,113 @@ shash_table_t *shash_table_create(unsigned long int size)
 
 	ht->shead = NULL;
 	ht->stail = NULL;
+	for (i = 0; i < SHT_MAX_LEVEL; i++)
+		ht->sfwd[i] = NULL;
+	ht->slevel = 0;
+	ht->srand = 0x2545f4914f6cdd1dUL;
+	ht->pool = NULL;
 	return (ht);
 }
 
 /**
- * sorted_insert - Inserts a node into the sorted dll by ASCII key
- * @ht: Sorted hash table
- * @node: Node to insert (assumes node->sprev/snext are NULL)
+ * random_level - Draws the number of skip list levels of a new node
+ * @ht: Sorted hash table (its xorshift state is advanced)
  *
- * Return: void
+ * Description: Each level is kept with probability 1/4.
+ * Return: A level in [0, SHT_MAX_LEVEL]
  */
-static void sorted_insert(shash_table_t *ht, shash_node_t *node)
+static int random_level(shash_table_t *ht)
 {
-	shash_node_t *cur;
-
-	if (ht->shead == NULL)
+	unsigned long int r;
+	int level = 0;
+
+	ht->srand ^= ht->srand << 13;
+	ht->srand ^= ht->srand >> 7;
+	ht->srand ^= ht->srand << 17;
+	r = ht->srand;
+	while (level < SHT_MAX_LEVEL && (r & 3) == 0)
 	{
-		ht->shead = node;
-		ht->stail = node;
-		return;
+		level++;
+		r >>= 2;
 	}
+	return (level);
+}
 
-	cur = ht->shead;
-	while (cur && strcmp(node->key, cur->key) > 0)
-		cur = cur->snext;
+/**
+ * shash_table_lower - Finds the last node with a key lower than a key
+ * @ht: Sorted hash table
+ * @key: Key to compare with
+ * @preds: If not NULL, receives for each skip list level the last node
+ *         of that level with a key lower than @key (NULL for the head)
+ *
+ * Description: Walks the skip list from its top level down, which takes
+ * O(log n) comparisons on average.
+ * Return: The last node whose key is lower than @key, or NULL if none
+ */
+shash_node_t *shash_table_lower(const shash_table_t *ht, const char *key,
+				shash_node_t **preds)
+{
+	shash_node_t *x = NULL, *next;
+	int lvl;
 
-	if (cur == ht->shead)
+	for (lvl = ht->slevel; lvl > 0; lvl--)
 	{
-		/* insert at head */
-		node->snext = ht->shead;
-		ht->shead->sprev = node;
-		ht->shead = node;
+		next = x != NULL ? x->sfwd[lvl - 1] : ht->sfwd[lvl - 1];
+		while (next != NULL && strcmp(next->key, key) < 0)
+		{
+			x = next;
+			next = x->sfwd[lvl - 1];
+		}
+		if (preds != NULL)
+			preds[lvl - 1] = x;
 	}
-	else if (cur == NULL)
+	next = x != NULL ? x->snext : ht->shead;
+	while (next != NULL && strcmp(next->key, key) < 0)
 	{
-		/* insert at tail */
-		node->sprev = ht->stail;
-		ht->stail->snext = node;
-		ht->stail = node;
+		x = next;
+		next = x->snext;
 	}
-	else
+	return (x);
+}
+
+/**
+ * sorted_insert - Inserts a node into the sorted dll by ASCII key
+ * @ht: Sorted hash table
+ * @node: Node to insert (assumes node->sprev/snext are NULL)
+ *
+ * Description: The node is also linked into the skip list levels it was
+ * created with, so finding its place costs O(log n) on average.
+ * Return: void
+ */
+static void sorted_insert(shash_table_t *ht, shash_node_t *node)
+{
+	shash_node_t *preds[SHT_MAX_LEVEL], *prev, **link;
+	int lvl;
+
+	prev = shash_table_lower(ht, node->key, preds);
+	for (lvl = ht->slevel; lvl < node->slevel; lvl++)
+		preds[lvl] = NULL;
+	if (node->slevel > ht->slevel)
+		ht->slevel = node->slevel;
+	for (lvl = 0; lvl < node->slevel; lvl++)
 	{
-		/* insert before cur */
-		node->snext = cur;
-		node->sprev = cur->sprev;
-		cur->sprev->snext = node;
-		cur->sprev = node;
+		link = &ht->sfwd[lvl];
+		if (preds[lvl] != NULL)
+			link = &preds[lvl]->sfwd[lvl];
+		node->sfwd[lvl] = *link;
+		*link = node;
 	}
+
+	node->sprev = prev;
+	node->snext = prev != NULL ? prev->snext : ht->shead;
+	if (prev != NULL)
+		prev->snext = node;
+	else
+		ht->shead = node;
+	if (node->snext != NULL)
+		node->snext->sprev = node;
+	else
+		ht->stail = node;
 }
 
 /**
@@ -120,19 +195,37 @@ static void sorted_insert(shash_table_t *ht, shash_node_t *node)
  * @head: Head of a bucket chain
  * @key: Key to search
  *
+ * Description: A key given by the pool of the table matches its node by
+ * address; other keys are compared as strings, rather than looked up in
+ * the pool first.
  * Return: Pointer to node if found, NULL otherwise
  */
 static shash_node_t *chain_find(shash_node_t *head, const char *key)
 {
 	while (head)
 	{
-		if (strcmp(head->key, key) == 0)
+		if (head->key == key || strcmp(head->key, key) == 0)
 			return (head);
 		head = head->next;
 	}
 	return (NULL);
 }
 
+/**
+ * shash_table_set_pool - Makes a sorted hash table intern its keys
+ * @ht: Sorted hash table, still empty
+ * @pool: Pool to intern keys in (which must outlive the table)
+ *
+ * Return: 1 on success, 0 if the table already holds elements
+ */
+int shash_table_set_pool(shash_table_t *ht, str_pool_t *pool)
+{
+	if (ht == NULL || ht->shead != NULL)
+		return (0);
+	ht->pool = pool;
+	return (1);
+}
+
 /**
  * shash_table_set - Adds/updates an element in a sorted hash table
  * @ht: Sorted hash table
@@ -162,7 +255,7 @@ int shash_table_set(shash_table_t *ht, const char *key, const char *value)
 		return (1);
 	}
 
-	n = shash_node_create(key, value);
+	n = shash_node_create(key, value, random_level(ht), ht->pool);
 	if (n == NULL)
 		return (0);
 
@@ -192,15 +285,10 @@ char *shash_table_get(const shash_table_t *ht, const char *key)
 		return (NULL);
 
 	idx = key_index((const unsigned char *)key, ht->size);
-	n = ht->array[idx];
-
-	while (n)
-	{
-		if (strcmp(n->key, key) == 0)
-			return (n->value);
-		n = n->next;
-	}
-	return (NULL);
+	n = chain_find(ht->array[idx], key);
+	if (n == NULL)
+		return (NULL);
+	return (n->value);
 }
 
 /**
@@ -274,7 +362,10 @@ void shash_table_delete(shash_table_t *ht)
 	while (n)
 	{
 		tmp = n->snext;
-		free(n->key);
+		if (ht->pool != NULL)
+			str_pool_release(ht->pool, n->key);
+		else
+			free(n->key);
 		free(n->value);
 		free(n);
 		n = tmp;
@@ -0,0 +1,213 @@
+#include "hash_map.h"
+
+/**
+ * oa_slot_hash - Gives the hash stored in a slot
+ * @s: The slot
+ *
+ * Return: oa_hash() of the key of @s
+ */
+static unsigned long int oa_slot_hash(const oa_slot_t *s)
+{
+	return (s->hash);
+}
+
+/**
+ * oa_match - Tells whether a slot holds a key
+ * @s: The slot
+ * @key: The key
+ * @hash: oa_hash() of @key, compared before the key itself
+ *
+ * Return: 1 if @s holds @key, 0 otherwise
+ */
+static int oa_match(const oa_slot_t *s, const char *key,
+		    unsigned long int hash)
+{
+	return (s->hash == hash && strcmp(s->key, key) == 0);
+}
+
+HM_DEFINE_PROBE(oa, oa_hash_table_t, oa_slot_t, const char *, oa_slot_hash,
+		oa_match)
+
+/**
+ * oa_hash - Hashes a key with the seeded hash of a table
+ * @ht: Table
+ * @key: Key
+ *
+ * Return: hash_xx() of @key, seeded with @ht->seed
+ */
+static unsigned long int oa_hash(const oa_hash_table_t *ht, const char *key)
+{
+	return (hash_xx(key, strlen(key), ht->seed));
+}
+
+/**
+ * oa_hash_table_create - Creates an open-addressing hash table
+ * @size: Minimum number of slots (rounded up to a power of two)
+ *
+ * Return: A pointer to the newly created hash table,
+ *         or NULL if something went wrong
+ */
+oa_hash_table_t *oa_hash_table_create(unsigned long int size)
+{
+	oa_hash_table_t *ht;
+
+	if (size == 0)
+		return (NULL);
+
+	ht = malloc(sizeof(oa_hash_table_t));
+	if (ht == NULL)
+		return (NULL);
+	ht->seed = hash_random_seed();
+	if (!oa_init(ht, size))
+	{
+		free(ht);
+		return (NULL);
+	}
+	return (ht);
+}
+
+/**
+ * oa_hash_table_set - Adds or updates an element in the table
+ * @ht: Pointer to the hash table
+ * @key: The key (cannot be an empty string)
+ * @value: The value associated with the key (will be duplicated)
+ *
+ * Description: The table grows as described for HM_DEFINE_PROBE in
+ * hash_map.h; too many keys sharing a hash are turned down instead,
+ * with the table left as it was.
+ * Return: 1 if it succeeded, 0 otherwise
+ */
+int oa_hash_table_set(oa_hash_table_t *ht, const char *key,
+		      const char *value)
+{
+	unsigned long int hash, idx;
+	oa_slot_t s;
+	char *vdup;
+
+	if (ht == NULL || key == NULL || *key == '\0' || value == NULL)
+		return (0);
+
+	hash = oa_hash(ht, key);
+	vdup = strdup(value);
+	if (vdup == NULL)
+		return (0);
+	idx = oa_find(ht, key, hash);
+	if (idx != ht->size)
+	{
+		free(ht->slots[idx].value);
+		ht->slots[idx].value = vdup;
+		return (1);
+	}
+
+	s.hash = hash;
+	s.value = vdup;
+	s.key = strdup(key);
+	if (s.key == NULL || !oa_insert(ht, &s))
+	{
+		free(s.key);
+		free(vdup);
+		return (0);
+	}
+	return (1);
+}
+
+/**
+ * oa_hash_table_get - Retrieves a value associated with a key
+ * @ht: Pointer to the hash table
+ * @key: The key you are looking for
+ *
+ * Return: The value associated with the key,
+ *         or NULL if the key couldn't be found
+ */
+char *oa_hash_table_get(const oa_hash_table_t *ht, const char *key)
+{
+	unsigned long int idx;
+
+	if (ht == NULL || key == NULL || *key == '\0')
+		return (NULL);
+
+	idx = oa_find(ht, key, oa_hash(ht, key));
+	if (idx == ht->size)
+		return (NULL);
+	return (ht->slots[idx].value);
+}
+
+/**
+ * oa_hash_table_print - Prints an open-addressing hash table
+ * @ht: Pointer to the hash table
+ *
+ * Description: Same format as hash_table_print(), in slot order.
+ */
+void oa_hash_table_print(const oa_hash_table_t *ht)
+{
+	unsigned long int i;
+	int first = 1;
+
+	if (ht == NULL)
+		return;
+
+	printf("{");
+	for (i = 0; i < ht->size; i++)
+	{
+		if (ht->ctrl[i] == 0)
+			continue;
+		if (!first)
+			printf(", ");
+		printf("'%s': '%s'", ht->slots[i].key, ht->slots[i].value);
+		first = 0;
+	}
+	printf("}\n");
+}
+
+/**
+ * oa_hash_table_delete - Deletes an open-addressing hash table
+ * @ht: Pointer to the hash table
+ *
+ * Description: Frees all memory used by the hash table,
+ * including all keys and values.
+ */
+void oa_hash_table_delete(oa_hash_table_t *ht)
+{
+	unsigned long int i;
+
+	if (ht == NULL)
+		return;
+
+	for (i = 0; i < ht->size; i++)
+	{
+		if (ht->ctrl[i] != 0)
+		{
+			free(ht->slots[i].key);
+			free(ht->slots[i].value);
+		}
+	}
+	free(ht->ctrl);
+	free(ht->slots);
+	free(ht);
+}
+
+/**
+ * oa_hash_table_remove - Removes an element from the table
+ * @ht: Pointer to the hash table
+ * @key: The key of the element
+ *
+ * Description: Uses backward-shift deletion (oa_erase()): the entries
+ * following the removed one are moved back a slot until one is empty or
+ * already in its home slot, so no tombstone is needed.
+ * Return: 1 if the element was removed, 0 if it wasn't in the table
+ */
+int oa_hash_table_remove(oa_hash_table_t *ht, const char *key)
+{
+	unsigned long int idx;
+
+	if (ht == NULL || key == NULL || *key == '\0')
+		return (0);
+
+	idx = oa_find(ht, key, oa_hash(ht, key));
+	if (idx == ht->size)
+		return (0);
+	free(ht->slots[idx].key);
+	free(ht->slots[idx].value);
+	oa_erase(ht, idx);
+	return (1);
+}
@@ -0,0 +1,155 @@
+#include "hash_tables.h"
+
+/**
+ * hash_table_bucket - Finds the bucket list a key belongs to
+ * @ht: Pointer to the hash table
+ * @hash: The hash of the key
+ *
+ * Description: While a rehash is pending, keys whose old bucket has not
+ * been migrated yet still live in @ht->old_array.
+ * Return: Pointer to the head of the bucket list
+ */
+hash_node_t **hash_table_bucket(const hash_table_t *ht,
+				unsigned long int hash)
+{
+	unsigned long int i;
+
+	if (ht->old_array != NULL)
+	{
+		i = hash_index(hash, ht->old_size, ht->index_mode);
+		if (i >= ht->rehash_pos)
+			return (&ht->old_array[i]);
+	}
+	i = hash_index(hash, ht->size, ht->index_mode);
+	return (&ht->array[i]);
+}
+
+/**
+ * hash_table_rehash_step - Migrates buckets of a pending rehash
+ * @ht: Pointer to the hash table
+ * @n: Maximum number of old buckets to migrate
+ *
+ * Description: Nodes are relinked, never copied, and their cached hash
+ * spares hashing the keys again. The old array is freed once its last
+ * bucket has been migrated.
+ */
+void hash_table_rehash_step(hash_table_t *ht, unsigned long int n)
+{
+	hash_node_t *node, *tmp, **bucket;
+	unsigned long int i;
+
+	while (ht->old_array != NULL && n-- > 0)
+	{
+		node = ht->old_array[ht->rehash_pos];
+		ht->old_array[ht->rehash_pos] = NULL;
+		ht->rehash_pos++;
+		while (node != NULL)
+		{
+			tmp = node->next;
+			i = hash_index(node->hash, ht->size, ht->index_mode);
+			bucket = &ht->array[i];
+			node->next = *bucket;
+			*bucket = node;
+			node = tmp;
+		}
+		if (ht->rehash_pos == ht->old_size)
+		{
+			free(ht->old_array);
+			ht->old_array = NULL;
+			ht->old_size = 0;
+			ht->rehash_pos = 0;
+		}
+	}
+}
+
+/**
+ * resize_to - Moves the elements of a hash table to a new bucket array
+ * @ht: Pointer to the hash table
+ * @size: The new size of the array
+ * @incremental: Nonzero to leave the migration to later operations
+ *
+ * Return: 1 if it succeeded, 0 otherwise (@ht is left unchanged)
+ */
+static int resize_to(hash_table_t *ht, unsigned long int size,
+		     int incremental)
+{
+	hash_node_t **array;
+
+	array = calloc(size, sizeof(hash_node_t *));
+	if (array == NULL)
+		return (0);
+
+	hash_table_rehash_step(ht, ht->old_size);
+	ht->old_array = ht->array;
+	ht->old_size = ht->size;
+	ht->rehash_pos = 0;
+	ht->array = array;
+	ht->size = size;
+	if (!incremental)
+		hash_table_rehash_step(ht, ht->old_size);
+	return (1);
+}
+
+/**
+ * hash_table_grow - Doubles the size of a hash table that is too loaded
+ * @ht: Pointer to the hash table
+ *
+ * Description: Nothing is done while the table holds at most one element
+ * per bucket, or while a previous rehash is still pending.
+ * Return: 1 if the table is large enough or has grown, 0 on failure
+ */
+int hash_table_grow(hash_table_t *ht)
+{
+	if (ht->count <= ht->size || ht->old_array != NULL)
+		return (1);
+	if (ht->size * 2 < ht->size)
+		return (0);
+	return (resize_to(ht, ht->size * 2, ht->incremental));
+}
+
+/**
+ * hash_table_reserve - Pre-sizes a hash table for a number of elements
+ * @ht: Pointer to the hash table
+ * @n: Number of elements the table should hold without growing
+ *
+ * Description: Any pending rehash is completed, and the table is rehashed
+ * at once if it has fewer than @n buckets. Except for HT_INDEX_FASTRANGE
+ * tables, @n is rounded up to the size of the table doubled as many
+ * times as needed, which keeps hash_table_scan() cursors valid (and
+ * HT_INDEX_MASK sizes powers of two).
+ * Return: 1 if it succeeded, 0 otherwise
+ */
+int hash_table_reserve(hash_table_t *ht, unsigned long int n)
+{
+	unsigned long int size;
+
+	if (ht == NULL)
+		return (0);
+
+	hash_table_rehash_step(ht, ht->old_size);
+	if (n <= ht->size)
+		return (1);
+	size = ht->index_mode == HT_INDEX_FASTRANGE ? n : ht->size;
+	while (size < n)
+	{
+		if (size * 2 < size)
+			return (0);
+		size *= 2;
+	}
+	return (resize_to(ht, size, 0));
+}
+
+/**
+ * hash_pow2 - Rounds a size up to a power of two
+ * @n: The size
+ *
+ * Return: The smallest power of two >= @n, or 0 if it doesn't fit
+ */
+unsigned long int hash_pow2(unsigned long int n)
+{
+	unsigned long int p = 1;
+
+	while (p < n && p != 0)
+		p <<= 1;
+	return (p);
+}
@@ -0,0 +1,161 @@
+#include "hash_tables.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+#define XX_P1 0x9e3779b185ebca87UL
+#define XX_P2 0xc2b2ae3d27d4eb4fUL
+#define XX_P3 0x165667b19e3779f9UL
+#define XX_P4 0x85ebca77c2b2ae63UL
+#define XX_P5 0x27d4eb2f165667c5UL
+#define ROTL(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+const hash_func_t hash_func_djb2 = {"djb2", hash_djb2_seeded};
+const hash_func_t hash_func_xx = {"xx", hash_xx};
+
+/**
+ * hash_djb2_seeded - djb2 over a buffer, with a seeded initial state
+ * @key: Bytes to hash
+ * @len: Number of bytes in @key
+ * @seed: Seed (0 gives the same result as hash_djb2())
+ *
+ * Return: The computed hash
+ */
+unsigned long int hash_djb2_seeded(const void *key, size_t len,
+				   unsigned long int seed)
+{
+	const unsigned char *p = key;
+	unsigned long int hash = 5381 ^ seed;
+
+	while (len-- > 0)
+		hash = ((hash << 5) + hash) + *p++; /* hash * 33 + c */
+
+	return (hash);
+}
+
+/**
+ * xx_round - Mixes one 8-byte word into an xxHash64 accumulator
+ * @acc: Accumulator
+ * @in: Word to mix in
+ *
+ * Return: The new accumulator
+ */
+static unsigned long int xx_round(unsigned long int acc, unsigned long int in)
+{
+	acc += in * XX_P2;
+	acc = ROTL(acc, 31);
+	return (acc * XX_P1);
+}
+
+/**
+ * xx_lanes - Consumes 32-byte stripes with four independent accumulators
+ * @p: Pointer to the bytes, advanced past the consumed stripes
+ * @len: Number of bytes left, decreased accordingly
+ * @seed: Seed
+ *
+ * Description: The four lanes have no dependency on each other, so
+ * long keys are hashed several words per cycle.
+ * Return: The merged accumulator
+ */
+static unsigned long int xx_lanes(const unsigned char **p, size_t *len,
+				  unsigned long int seed)
+{
+	unsigned long int v[4], w[4], h;
+	int i;
+
+	v[0] = seed + XX_P1 + XX_P2;
+	v[1] = seed + XX_P2;
+	v[2] = seed;
+	v[3] = seed - XX_P1;
+	while (*len >= 32)
+	{
+		memcpy(w, *p, 32);
+		for (i = 0; i < 4; i++)
+			v[i] = xx_round(v[i], w[i]);
+		*p += 32;
+		*len -= 32;
+	}
+	h = ROTL(v[0], 1) + ROTL(v[1], 7) + ROTL(v[2], 12) + ROTL(v[3], 18);
+	for (i = 0; i < 4; i++)
+	{
+		h ^= xx_round(0, v[i]);
+		h = h * XX_P1 + XX_P4;
+	}
+	return (h);
+}
+
+/**
+ * hash_xx - xxHash64-style word-at-a-time hash
+ * @key: Bytes to hash
+ * @len: Number of bytes in @key
+ * @seed: Seed
+ *
+ * Description: Reads 8 bytes per step (unaligned loads through memcpy)
+ * and ends with a full avalanche, so keys sharing a long prefix still
+ * spread over every bit of the result.
+ * Return: The computed hash
+ */
+unsigned long int hash_xx(const void *key, size_t len, unsigned long int seed)
+{
+	const unsigned char *p = key;
+	unsigned long int h, w;
+	unsigned int w4;
+
+	h = len >= 32 ? xx_lanes(&p, &len, seed) : seed + XX_P5;
+	h += len;
+	for (; len >= 8; p += 8, len -= 8)
+	{
+		memcpy(&w, p, 8);
+		h ^= xx_round(0, w);
+		h = ROTL(h, 27) * XX_P1 + XX_P4;
+	}
+	if (len >= 4)
+	{
+		memcpy(&w4, p, 4);
+		h ^= (unsigned long int)w4 * XX_P1;
+		h = ROTL(h, 23) * XX_P2 + XX_P3;
+		p += 4;
+		len -= 4;
+	}
+	for (; len > 0; p++, len--)
+	{
+		h ^= *p * XX_P5;
+		h = ROTL(h, 11) * XX_P1;
+	}
+	h ^= h >> 33;
+	h *= XX_P2;
+	h ^= h >> 29;
+	h *= XX_P3;
+	h ^= h >> 32;
+	return (h);
+}
+
+/**
+ * hash_random_seed - Draws a seed to resist hash-flooding attacks
+ *
+ * Description: Reads /dev/urandom, falling back to the clock, the
+ * process ID and the address of a local variable (randomized by ASLR)
+ * if it can't be read.
+ * Return: A seed for hash_opts_t
+ */
+unsigned long int hash_random_seed(void)
+{
+	unsigned long int seed = 0;
+	void *p;
+	int fd;
+
+	fd = open("/dev/urandom", O_RDONLY);
+	if (fd != -1)
+	{
+		if (read(fd, &seed, sizeof(seed)) != (ssize_t)sizeof(seed))
+			seed = 0;
+		close(fd);
+	}
+	if (seed == 0)
+	{
+		p = &fd;
+		seed = hash_xx(&p, sizeof(p), (unsigned long int)time(NULL));
+		seed = hash_xx(&seed, sizeof(seed), (unsigned long int)getpid());
+	}
+	return (seed);
+}
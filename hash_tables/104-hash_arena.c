@@ -0,0 +1,109 @@
+#include "hash_tables.h"
+
+/**
+ * hash_arena_create - Creates an empty arena
+ * @slab_size: Size of the slabs carved by the arena (0 for HT_SLAB_SIZE)
+ *
+ * Return: A pointer to the new arena, or NULL on failure
+ */
+hash_arena_t *hash_arena_create(size_t slab_size)
+{
+	hash_arena_t *a;
+
+	a = malloc(sizeof(hash_arena_t));
+	if (a == NULL)
+		return (NULL);
+	a->slabs = NULL;
+	a->slab_size = slab_size != 0 ? slab_size : HT_SLAB_SIZE;
+	return (a);
+}
+
+/**
+ * slab_new - Allocates a slab and links it into an arena
+ * @a: The arena
+ * @size: Usable size of the slab
+ * @front: Nonzero to make it the slab allocations are carved from,
+ *         zero to link it behind the current one
+ *
+ * Return: A pointer to the new slab, or NULL on failure
+ */
+static hash_slab_t *slab_new(hash_arena_t *a, size_t size, int front)
+{
+	hash_slab_t *s;
+
+	s = malloc(sizeof(hash_slab_t) + size);
+	if (s == NULL)
+		return (NULL);
+	s->size = size;
+	s->used = 0;
+	if (front || a->slabs == NULL)
+	{
+		s->next = a->slabs;
+		a->slabs = s;
+	}
+	else
+	{
+		s->next = a->slabs->next;
+		a->slabs->next = s;
+	}
+	return (s);
+}
+
+/**
+ * hash_arena_alloc - Bump-allocates memory from an arena
+ * @a: The arena
+ * @n: Number of bytes
+ * @align: Required alignment (a power of two, at most sizeof(void *))
+ *
+ * Description: Requests larger than a quarter of a slab get a slab of
+ * their own, so they don't waste the rest of the current one.
+ * Return: A pointer to @n bytes that live until hash_arena_destroy(),
+ *         or NULL on failure
+ */
+void *hash_arena_alloc(hash_arena_t *a, size_t n, size_t align)
+{
+	hash_slab_t *s = a->slabs;
+	size_t off;
+
+	if (n > a->slab_size / 4)
+	{
+		s = slab_new(a, n, 0);
+		if (s == NULL)
+			return (NULL);
+		s->used = n;
+		return (s + 1);
+	}
+	off = s != NULL ? (s->used + align - 1) & ~(align - 1) : 0;
+	if (s == NULL || off + n > s->size)
+	{
+		s = slab_new(a, a->slab_size, 1);
+		if (s == NULL)
+			return (NULL);
+		off = 0;
+	}
+	s->used = off + n;
+	return ((char *)(s + 1) + off);
+}
+
+/**
+ * hash_arena_destroy - Frees an arena and everything allocated from it
+ * @a: The arena (may be NULL)
+ *
+ * Description: Runs in time proportional to the number of slabs.
+ */
+void hash_arena_destroy(hash_arena_t *a)
+{
+	hash_slab_t *s, *tmp;
+
+	if (a == NULL)
+		return;
+
+	s = a->slabs;
+	while (s != NULL)
+	{
+		tmp = s->next;
+		free(s);
+		s = tmp;
+	}
+	free(a);
+}
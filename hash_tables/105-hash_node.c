@@ -0,0 +1,314 @@
+#include "hash_tables.h"
+
+/**
+ * node_alloc - Allocates memory for a node or its strings
+ * @ht: Pointer to the hash table
+ * @n: Number of bytes
+ * @align: Alignment needed when carved from the arena of @ht
+ *
+ * Return: A pointer to @n bytes, or NULL on failure
+ */
+static void *node_alloc(hash_table_t *ht, size_t n, size_t align)
+{
+	if (ht->arena != NULL)
+		return (hash_arena_alloc(ht->arena, n, align));
+	return (malloc(n));
+}
+
+/**
+ * node_free - Releases memory obtained from node_alloc()
+ * @ht: Pointer to the hash table
+ * @p: Memory to release
+ *
+ * Description: Arena memory is only released with the whole arena.
+ */
+static void node_free(const hash_table_t *ht, void *p)
+{
+	if (ht->arena == NULL)
+		free(p);
+}
+
+/**
+ * hash_node_value_inline - Tells whether a value is stored in its node
+ * @ht: Pointer to the hash table
+ * @vlen: Length of the value
+ *
+ * Return: 1 if @ht stores a value of @vlen bytes inline, 0 otherwise
+ */
+int hash_node_value_inline(const hash_table_t *ht, size_t vlen)
+{
+	return (ht->inline_strings && vlen < HT_INLINE_MAX);
+}
+
+/**
+ * node_ptrs - Gives the pointers stored right behind a compact node
+ * @node: The node (a hash_cnode_t)
+ *
+ * Return: The value pointer and/or key pointer of @node
+ */
+static char **node_ptrs(const hash_node_t *node)
+{
+	return ((char **)((const hash_cnode_t *)node + 1));
+}
+
+/**
+ * node_bytes - Gives the key and value bytes stored in a compact node
+ * @ht: Pointer to the hash table holding @node
+ * @node: The node (a hash_cnode_t)
+ *
+ * Return: Pointer to the bytes following the pointers of @node
+ */
+static char *node_bytes(const hash_table_t *ht, const hash_node_t *node)
+{
+	return ((char *)(node_ptrs(node) +
+			 !hash_node_value_inline(ht, node->value_len) +
+			 (ht->pool != NULL)));
+}
+
+/**
+ * hash_node_key - Gives the key of a node
+ * @ht: Pointer to the hash table holding @node
+ * @node: The node
+ *
+ * Return: The key, followed by a NUL byte
+ */
+char *hash_node_key(const hash_table_t *ht, const hash_node_t *node)
+{
+	if (!ht->inline_strings)
+		return (node->key);
+	if (ht->pool != NULL)
+		return (node_ptrs(node)[!hash_node_value_inline(ht,
+							node->value_len)]);
+	return (node_bytes(ht, node));
+}
+
+/**
+ * hash_node_value - Gives the value of a node
+ * @ht: Pointer to the hash table holding @node
+ * @node: The node
+ *
+ * Return: The value, followed by a NUL byte
+ */
+char *hash_node_value(const hash_table_t *ht, const hash_node_t *node)
+{
+	if (!ht->inline_strings)
+		return (node->value);
+	if (!hash_node_value_inline(ht, node->value_len))
+		return (node_ptrs(node)[0]);
+	if (ht->pool != NULL)
+		return (node_bytes(ht, node));
+	return (node_bytes(ht, node) + node->key_len + 1);
+}
+
+/**
+ * node_set_value_ptr - Points a node at a value stored on its own
+ * @ht: Pointer to the hash table holding @node
+ * @node: The node
+ * @v: The value
+ */
+static void node_set_value_ptr(const hash_table_t *ht, hash_node_t *node,
+			       char *v)
+{
+	if (ht->inline_strings)
+		node_ptrs(node)[0] = v;
+	else
+		node->value = v;
+}
+
+/**
+ * hash_node_size - Gives the bytes used by a node and its value
+ * @ht: Pointer to the hash table holding @node
+ * @node: The node
+ *
+ * Description: Interned keys belong to their pool and aren't counted.
+ * Return: Number of bytes (allocator overhead not included)
+ */
+size_t hash_node_size(const hash_table_t *ht, const hash_node_t *node)
+{
+	size_t n = sizeof(hash_node_t);
+
+	if (ht->inline_strings)
+		n = node_bytes(ht, node) - (const char *)node;
+	if (ht->pool == NULL)
+		n += node->key_len + 1;
+	return (n + node->value_len + 1);
+}
+
+/**
+ * node_size - Gives the size of the block of a new node
+ * @ht: Pointer to the hash table the node is for
+ * @len: Length of the key
+ * @vlen: Length of the value
+ *
+ * Return: Number of bytes, the key included unless @ht interns it
+ */
+static size_t node_size(const hash_table_t *ht, size_t len, size_t vlen)
+{
+	int vin = hash_node_value_inline(ht, vlen);
+	size_t n = ht->pool == NULL ? len + 1 : 0;
+
+	if (!ht->inline_strings)
+		return (sizeof(hash_node_t) + n);
+	n += sizeof(hash_cnode_t) + (vin ? vlen + 1 : 0);
+	return (n + (!vin + (ht->pool != NULL)) * sizeof(char *));
+}
+
+/**
+ * node_fill - Sets up a new node and copies its strings
+ * @ht: Pointer to the hash table the node is for
+ * @node: The node, of node_size() bytes
+ * @k: Interned key, or NULL to copy @key into the node
+ * @key: Key bytes
+ * @v: Block for the value if it isn't inline, or NULL
+ * @value: Value bytes
+ *
+ * Description: @node->key_len and @node->value_len must be set.
+ */
+static void node_fill(const hash_table_t *ht, hash_node_t *node, char *k,
+		      const char *key, char *v, const char *value)
+{
+	char **ptrs = node_ptrs(node);
+
+	if (!ht->inline_strings)
+	{
+		node->key = k != NULL ? k : (char *)(node + 1);
+		node->value = v;
+	}
+	else if (v != NULL)
+		ptrs[0] = v;
+	if (ht->inline_strings && k != NULL)
+		ptrs[v != NULL] = k;
+	if (k == NULL)
+	{
+		k = hash_node_key(ht, node);
+		memcpy(k, key, node->key_len);
+		k[node->key_len] = '\0';
+	}
+	v = hash_node_value(ht, node);
+	memcpy(v, value, node->value_len);
+	v[node->value_len] = '\0';
+}
+
+/**
+ * hash_node_create - Creates a new hash node (key/value duplicated)
+ * @ht: Pointer to the hash table the node is for
+ * @key: Key bytes (non-empty)
+ * @len: Length of @key
+ * @hash: The hash of @key
+ * @value: Value bytes
+ * @vlen: Length of @value
+ *
+ * Description: The key is copied right behind the node, in the same
+ * allocation, since it never changes; when @ht interns its keys, the
+ * node references the copy held by the pool instead. The value has a
+ * block of its own, except in the compact nodes of an inline_strings
+ * table, where values shorter than HT_INLINE_MAX are copied behind the
+ * key, and the node then holds no pointer at all.
+ * Return: Pointer to new node, or NULL on failure
+ */
+hash_node_t *hash_node_create(hash_table_t *ht, const char *key, size_t len,
+			      unsigned long int hash, const char *value,
+			      size_t vlen)
+{
+	hash_node_t *node;
+	char *v = NULL, *k = NULL;
+
+	if (len > HT_LEN_MAX || vlen > HT_LEN_MAX)
+		return (NULL);
+	if (!hash_node_value_inline(ht, vlen))
+	{
+		v = node_alloc(ht, vlen + 1, 1);
+		if (v == NULL)
+			return (NULL);
+	}
+	if (ht->pool != NULL)
+		k = (char *)str_pool_intern(ht->pool, key, len);
+	node = ht->pool == NULL || k != NULL ?
+		node_alloc(ht, node_size(ht, len, vlen), sizeof(void *)) : NULL;
+	if (node == NULL)
+	{
+		if (k != NULL)
+			str_pool_release(ht->pool, k);
+		node_free(ht, v);
+		return (NULL);
+	}
+	node->next = NULL;
+	node->hash = hash;
+	node->key_len = len;
+	node->value_len = vlen;
+	node_fill(ht, node, k, key, v, value);
+	return (node);
+}
+
+/**
+ * hash_node_set_value - Replaces the value of a node
+ * @ht: Pointer to the hash table holding the node
+ * @link: Pointer to the node, in its bucket list
+ * @value: New value (will be duplicated)
+ * @vlen: Length of @value
+ *
+ * Description: An inline value no longer than the old one is copied over
+ * it. A value stored on its own replaces the old one, or in arena mode
+ * is copied over it if it fits; otherwise the old bytes stay unused until
+ * the table is deleted. In the other cases the node is rebuilt to hold
+ * the new value, and *@link is updated.
+ * Return: 1 if it succeeded, 0 otherwise
+ */
+int hash_node_set_value(hash_table_t *ht, hash_node_t **link,
+			const char *value, size_t vlen)
+{
+	hash_node_t *node = *link, *copy;
+	char *old = hash_node_value(ht, node), *vdup = NULL;
+	int vin = hash_node_value_inline(ht, vlen);
+
+	if (vlen > HT_LEN_MAX)
+		return (0);
+	if (vin && hash_node_value_inline(ht, node->value_len) &&
+	    vlen <= node->value_len)
+		vdup = old;
+	else if (!vin && !hash_node_value_inline(ht, node->value_len))
+	{
+		if (ht->arena != NULL && vlen <= node->value_len)
+			vdup = old;
+		else
+			vdup = node_alloc(ht, vlen + 1, 1);
+		if (vdup == NULL)
+			return (0);
+	}
+	if (vdup != NULL)
+	{
+		memmove(vdup, value, vlen);
+		vdup[vlen] = '\0';
+		if (vdup != old)
+			node_free(ht, old);
+		if (!vin)
+			node_set_value_ptr(ht, node, vdup);
+		node->value_len = vlen;
+		return (1);
+	}
+
+	copy = hash_node_create(ht, hash_node_key(ht, node), node->key_len,
+				node->hash, value, vlen);
+	if (copy == NULL)
+		return (0);
+	copy->next = node->next;
+	*link = copy;
+	hash_node_free(ht, node);
+	return (1);
+}
+
+/**
+ * hash_node_free - Frees a node, its key and its value
+ * @ht: Pointer to the hash table that held @node
+ * @node: The node
+ *
+ * Description: An interned key is given back to the pool instead.
+ */
+void hash_node_free(const hash_table_t *ht, hash_node_t *node)
+{
+	if (ht->pool != NULL)
+		str_pool_release(ht->pool, hash_node_key(ht, node));
+	if (!hash_node_value_inline(ht, node->value_len))
+		node_free(ht, hash_node_value(ht, node));
+	node_free(ht, node);
+}
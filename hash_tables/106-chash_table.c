@@ -0,0 +1,202 @@
+#include "hash_tables.h"
+
+/**
+ * chash_table_create - Creates a hash table safe for concurrent use
+ * @size: The size of the array (rounded up to a power of two)
+ * @nlocks: Number of lock stripes (rounded up to a power of two,
+ *          0 for CHT_DEFAULT_LOCKS)
+ *
+ * Description: Stripes are picked from the low bits of the mixed hash,
+ * like buckets, so each bucket is guarded by exactly one stripe.
+ * Return: A pointer to the newly created table, or NULL on failure
+ */
+chash_table_t *chash_table_create(unsigned long int size,
+				  unsigned long int nlocks)
+{
+	chash_table_t *cht;
+	hash_opts_t opts;
+	unsigned long int i;
+
+	nlocks = hash_pow2(nlocks != 0 ? nlocks : CHT_DEFAULT_LOCKS);
+	if (nlocks == 0)
+		return (NULL);
+	memset(&opts, 0, sizeof(opts));
+	opts.index_mode = HT_INDEX_MASK;
+	cht = malloc(sizeof(chash_table_t));
+	if (cht == NULL)
+		return (NULL);
+	cht->ht = hash_table_create_opts(size < nlocks ? nlocks : size, &opts);
+	cht->locks = malloc(sizeof(*cht->locks) * nlocks);
+	if (cht->ht == NULL || cht->locks == NULL)
+	{
+		hash_table_delete(cht->ht);
+		free(cht->locks);
+		free(cht);
+		return (NULL);
+	}
+	cht->nlocks = nlocks;
+	for (i = 0; i < nlocks; i++)
+		pthread_rwlock_init(&cht->locks[i].lock, NULL);
+	return (cht);
+}
+
+/**
+ * chash_grow - Doubles the array of a table that is too loaded
+ * @cht: Pointer to the table
+ *
+ * Description: Takes every stripe, in order, so it runs alone. The
+ * caller must not hold any stripe.
+ */
+static void chash_grow(chash_table_t *cht)
+{
+	unsigned long int i;
+
+	for (i = 0; i < cht->nlocks; i++)
+		pthread_rwlock_wrlock(&cht->locks[i].lock);
+	if (cht->ht->count > cht->ht->size)
+		hash_table_reserve(cht->ht, cht->ht->size * 2);
+	for (i = 0; i < cht->nlocks; i++)
+		pthread_rwlock_unlock(&cht->locks[i].lock);
+}
+
+/**
+ * chash_table_set - Adds or updates an element, from any thread
+ * @cht: Pointer to the table
+ * @key: The key (cannot be an empty string)
+ * @value: The value associated with the key (will be duplicated)
+ *
+ * Return: 1 if it succeeded, 0 otherwise
+ */
+int chash_table_set(chash_table_t *cht, const char *key, const char *value)
+{
+	hash_table_t *ht;
+	hash_node_t **bucket, *node;
+	unsigned long int hash, size, count = 0;
+	pthread_rwlock_t *lock;
+	size_t len;
+	int ret = 1;
+
+	if (cht == NULL || key == NULL || *key == '\0' || value == NULL)
+		return (0);
+
+	ht = cht->ht;
+	len = strlen(key);
+	hash = hash_table_hash(ht, key, len);
+	lock = &cht->locks[hash_mix(hash) & (cht->nlocks - 1)].lock;
+	pthread_rwlock_wrlock(lock);
+	size = ht->size;
+	bucket = hash_table_bucket(ht, hash);
+	node = hash_chain_find(ht, *bucket, key, len, hash);
+	while (node != NULL && *bucket != node)
+		bucket = &(*bucket)->next;
+	if (node != NULL)
+		ret = hash_node_set_value(ht, bucket, value, strlen(value));
+	else
+	{
+		node = hash_node_create(ht, key, len, hash, value,
+					       strlen(value));
+		if (node == NULL)
+			ret = 0;
+		else
+		{
+			node->next = *bucket;
+			*bucket = node;
+			count = __sync_add_and_fetch(&ht->count, 1);
+		}
+	}
+	pthread_rwlock_unlock(lock);
+	if (count > size)
+		chash_grow(cht);
+	return (ret);
+}
+
+/**
+ * chash_table_get - Retrieves a copy of the value associated with a key
+ * @cht: Pointer to the table
+ * @key: The key you are looking for
+ *
+ * Description: Readers of a stripe run in parallel. A copy is returned
+ * because another thread may replace the value once the stripe is
+ * released.
+ * Return: A malloc'ed copy of the value, to be freed by the caller,
+ *         or NULL if the key couldn't be found
+ */
+char *chash_table_get(chash_table_t *cht, const char *key)
+{
+	hash_node_t *node;
+	unsigned long int hash;
+	pthread_rwlock_t *lock;
+	char *value = NULL;
+	size_t len;
+
+	if (cht == NULL || key == NULL || *key == '\0')
+		return (NULL);
+
+	len = strlen(key);
+	hash = hash_table_hash(cht->ht, key, len);
+	lock = &cht->locks[hash_mix(hash) & (cht->nlocks - 1)].lock;
+	pthread_rwlock_rdlock(lock);
+	node = hash_chain_find(cht->ht, *hash_table_bucket(cht->ht, hash), key,
+			       len, hash);
+	if (node != NULL)
+		value = strdup(hash_node_value(cht->ht, node));
+	pthread_rwlock_unlock(lock);
+	return (value);
+}
+
+/**
+ * chash_table_remove - Removes an element, from any thread
+ * @cht: Pointer to the table
+ * @key: The key of the element
+ *
+ * Return: 1 if the element was removed, 0 if it wasn't in the table
+ */
+int chash_table_remove(chash_table_t *cht, const char *key)
+{
+	hash_node_t **pp, *node;
+	unsigned long int hash;
+	pthread_rwlock_t *lock;
+	size_t len;
+
+	if (cht == NULL || key == NULL || *key == '\0')
+		return (0);
+
+	len = strlen(key);
+	hash = hash_table_hash(cht->ht, key, len);
+	lock = &cht->locks[hash_mix(hash) & (cht->nlocks - 1)].lock;
+	pthread_rwlock_wrlock(lock);
+	pp = hash_table_bucket(cht->ht, hash);
+	node = hash_chain_find(cht->ht, *pp, key, len, hash);
+	while (node != NULL && *pp != node)
+		pp = &(*pp)->next;
+	if (node != NULL)
+	{
+		*pp = node->next;
+		__sync_sub_and_fetch(&cht->ht->count, 1);
+	}
+	pthread_rwlock_unlock(lock);
+	if (node == NULL)
+		return (0);
+	hash_node_free(cht->ht, node);
+	return (1);
+}
+
+/**
+ * chash_table_delete - Deletes a concurrent hash table
+ * @cht: Pointer to the table
+ *
+ * Description: No other thread may use the table anymore.
+ */
+void chash_table_delete(chash_table_t *cht)
+{
+	unsigned long int i;
+
+	if (cht == NULL)
+		return;
+
+	for (i = 0; i < cht->nlocks; i++)
+		pthread_rwlock_destroy(&cht->locks[i].lock);
+	free(cht->locks);
+	hash_table_delete(cht->ht);
+	free(cht);
+}
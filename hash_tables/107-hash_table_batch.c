@@ -0,0 +1,143 @@
+#include "hash_tables.h"
+
+/**
+ * batch_hash - Hashes a group of keys and prefetches their buckets
+ * @ht: Pointer to the hash table
+ * @keys: Array of @n keys (NULL or empty keys are skipped)
+ * @n: Number of keys, at most HT_BATCH
+ * @lens: Receives the length of each key (0 for a skipped key)
+ * @hashes: Receives the hash of each key (0 for a skipped key)
+ *
+ * Description: Every bucket slot is requested before any of them is
+ * needed, so the cache misses of the whole group overlap.
+ */
+static void batch_hash(const hash_table_t *ht, const char **keys, size_t n,
+		       size_t *lens, unsigned long int *hashes)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+	{
+		lens[i] = 0;
+		hashes[i] = 0;
+		if (keys[i] == NULL || *keys[i] == '\0')
+			continue;
+		lens[i] = strlen(keys[i]);
+		hashes[i] = hash_table_hash(ht, keys[i], lens[i]);
+		__builtin_prefetch(hash_table_bucket(ht, hashes[i]));
+	}
+}
+
+/**
+ * batch_heads - Prefetches the first node of the buckets of a group
+ * @ht: Pointer to the hash table
+ * @m: Number of keys, at most HT_BATCH
+ * @lens: Length of each key (0 for a skipped key)
+ * @hashes: Hash of each key
+ * @heads: Receives the first node of the bucket of each key
+ * @pass: Receives 1 for each key to look for, 0 for a skipped key or
+ *        one the Bloom filter rules out
+ */
+static void batch_heads(const hash_table_t *ht, size_t m, const size_t *lens,
+			const unsigned long int *hashes, hash_node_t **heads,
+			int *pass)
+{
+	size_t j;
+
+	for (j = 0; j < m; j++)
+	{
+		heads[j] = NULL;
+		pass[j] = lens[j] != 0;
+		if (pass[j] && ht->bloom != NULL)
+			pass[j] = hash_bloom_test(ht, hashes[j]);
+		if (!pass[j])
+			continue;
+		heads[j] = *hash_table_bucket(ht, hashes[j]);
+		if (heads[j] != NULL)
+			__builtin_prefetch(heads[j]);
+	}
+}
+
+/**
+ * hash_table_get_batch - Retrieves the values of an array of keys
+ * @ht: Pointer to the hash table
+ * @keys: Array of @n keys
+ * @values: Receives the value of each key, or NULL if it isn't found
+ * @n: Number of keys
+ *
+ * Description: Keys are resolved HT_BATCH at a time in three passes:
+ * hash and prefetch the bucket slots, prefetch the first node of each
+ * bucket the Bloom filter lets through, then walk the chains. NULL or
+ * empty keys get a NULL value and are not counted as lookups.
+ * Return: Number of keys found
+ */
+size_t hash_table_get_batch(const hash_table_t *ht, const char **keys,
+			    char **values, size_t n)
+{
+	unsigned long int hashes[HT_BATCH];
+	size_t lens[HT_BATCH], i, j, m, found = 0, missed = 0;
+	hash_node_t *heads[HT_BATCH], *node;
+	int pass[HT_BATCH];
+
+	for (i = 0; ht != NULL && i < n; i += m)
+	{
+		m = n - i < HT_BATCH ? n - i : HT_BATCH;
+		batch_hash(ht, keys + i, m, lens, hashes);
+		batch_heads(ht, m, lens, hashes, heads, pass);
+		for (j = 0; j < m; j++)
+		{
+			node = NULL;
+			if (pass[j])
+				node = hash_chain_find(ht, heads[j],
+						       keys[i + j], lens[j],
+						       hashes[j]);
+			if (pass[j] && node == NULL && ht->bloom != NULL)
+				ht->bloom->false_positives++;
+			values[i + j] = node != NULL ?
+				hash_node_value(ht, node) : NULL;
+			found += node != NULL;
+			missed += node == NULL && lens[j] != 0;
+		}
+	}
+	if (ht != NULL && ht->counters != NULL)
+	{
+		ht->counters->get_hits += found;
+		ht->counters->get_misses += missed;
+	}
+	return (found);
+}
+
+/**
+ * hash_table_set_batch - Adds or updates an array of elements
+ * @ht: Pointer to the hash table
+ * @keys: Array of @n keys (cannot be empty strings)
+ * @values: Array of the @n values (will be duplicated)
+ * @n: Number of elements
+ *
+ * Description: Keys are hashed and their buckets prefetched HT_BATCH at
+ * a time before being inserted in order, so a key repeated in @keys ends
+ * up with its last value.
+ * Return: Number of elements that were set
+ */
+size_t hash_table_set_batch(hash_table_t *ht, const char **keys,
+			    const char **values, size_t n)
+{
+	unsigned long int hashes[HT_BATCH];
+	size_t lens[HT_BATCH], i, j, m, done = 0;
+
+	for (i = 0; ht != NULL && i < n; i += m)
+	{
+		m = n - i < HT_BATCH ? n - i : HT_BATCH;
+		batch_hash(ht, keys + i, m, lens, hashes);
+		for (j = 0; j < m; j++)
+		{
+			if (keys[i + j] == NULL || *keys[i + j] == '\0' ||
+			    values[i + j] == NULL)
+				continue;
+			done += hash_table_set_hashed(ht, keys[i + j], lens[j],
+						      hashes[j], values[i + j],
+						      strlen(values[i + j]));
+		}
+	}
+	return (done);
+}
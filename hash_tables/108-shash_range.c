@@ -0,0 +1,198 @@
+#include "hash_tables.h"
+
+/**
+ * shash_table_seek - Finds the first element whose key is >= a key
+ * @ht: Sorted hash table
+ * @key: Key to compare with
+ *
+ * Return: The element, or NULL if every key is lower than @key
+ */
+shash_node_t *shash_table_seek(const shash_table_t *ht, const char *key)
+{
+	shash_node_t *n;
+
+	if (ht == NULL || key == NULL)
+		return (NULL);
+
+	n = shash_table_lower(ht, key, NULL);
+	return (n != NULL ? n->snext : ht->shead);
+}
+
+/**
+ * shash_table_range - Visits the elements whose keys are in [lo, hi)
+ * @ht: Sorted hash table
+ * @lo: Lowest key visited, or NULL to start at the first element
+ * @hi: Key at which the scan stops, or NULL to go to the last element
+ * @visit: Called on each element in ascending key order
+ * @data: Passed to @visit
+ *
+ * Description: The first element is found through the skip list, so a
+ * query costs O(log n) plus the number of elements visited.
+ * Return: Number of elements visited
+ */
+unsigned long int shash_table_range(const shash_table_t *ht, const char *lo,
+				    const char *hi, hash_visit_t visit,
+				    void *data)
+{
+	shash_node_t *n;
+	unsigned long int count = 0;
+
+	if (ht == NULL || visit == NULL)
+		return (0);
+
+	n = lo != NULL ? shash_table_seek(ht, lo) : ht->shead;
+	while (n != NULL && (hi == NULL || strcmp(n->key, hi) < 0))
+	{
+		count++;
+		if (visit(n->key, n->value, data) != 0)
+			break;
+		n = n->snext;
+	}
+	return (count);
+}
+
+/**
+ * shash_table_prefix - Visits the elements whose keys start with a prefix
+ * @ht: Sorted hash table
+ * @prefix: The prefix
+ * @visit: Called on each element in ascending key order
+ * @data: Passed to @visit
+ *
+ * Return: Number of elements visited
+ */
+unsigned long int shash_table_prefix(const shash_table_t *ht,
+				     const char *prefix, hash_visit_t visit,
+				     void *data)
+{
+	shash_node_t *n;
+	unsigned long int count = 0;
+	size_t len;
+
+	if (ht == NULL || prefix == NULL || visit == NULL)
+		return (0);
+
+	len = strlen(prefix);
+	n = shash_table_seek(ht, prefix);
+	while (n != NULL && strncmp(n->key, prefix, len) == 0)
+	{
+		count++;
+		if (visit(n->key, n->value, data) != 0)
+			break;
+		n = n->snext;
+	}
+	return (count);
+}
+
+/**
+ * shash_table_range_rev - Visits the elements whose keys are in [lo, hi)
+ *                         in descending key order
+ * @ht: Sorted hash table
+ * @lo: Lowest key visited, or NULL to go to the first element
+ * @hi: Keys >= @hi are skipped, or NULL to start at the last element
+ * @visit: Called on each element in descending key order
+ * @data: Passed to @visit
+ *
+ * Return: Number of elements visited
+ */
+unsigned long int shash_table_range_rev(const shash_table_t *ht,
+					const char *lo, const char *hi,
+					hash_visit_t visit, void *data)
+{
+	shash_node_t *n;
+	unsigned long int count = 0;
+
+	if (ht == NULL || visit == NULL)
+		return (0);
+
+	n = hi != NULL ? shash_table_lower(ht, hi, NULL) : ht->stail;
+	while (n != NULL && (lo == NULL || strcmp(n->key, lo) >= 0))
+	{
+		count++;
+		if (visit(n->key, n->value, data) != 0)
+			break;
+		n = n->sprev;
+	}
+	return (count);
+}
+
+/**
+ * shash_cursor_seek - Positions a cursor on the first key >= a key
+ * @cur: The cursor
+ * @ht: Sorted hash table
+ * @key: Key to seek, or NULL for the first element
+ *
+ * Description: Seeking costs O(log n), moving the cursor O(1). A cursor
+ * stays valid as elements are added, until the table is deleted.
+ * Return: 1 if the cursor is on an element, 0 if it is past the end
+ */
+int shash_cursor_seek(shash_cursor_t *cur, const shash_table_t *ht,
+		      const char *key)
+{
+	if (cur == NULL)
+		return (0);
+
+	cur->node = NULL;
+	if (ht != NULL)
+		cur->node = key != NULL ? shash_table_seek(ht, key) : ht->shead;
+	return (cur->node != NULL);
+}
+
+/**
+ * shash_cursor_last - Positions a cursor on the last key <= a key
+ * @cur: The cursor
+ * @ht: Sorted hash table
+ * @key: Key to seek, or NULL for the last element
+ *
+ * Return: 1 if the cursor is on an element, 0 if it is before the start
+ */
+int shash_cursor_last(shash_cursor_t *cur, const shash_table_t *ht,
+		      const char *key)
+{
+	shash_node_t *n;
+
+	if (cur == NULL)
+		return (0);
+
+	cur->node = NULL;
+	if (ht != NULL && key == NULL)
+		cur->node = ht->stail;
+	else if (ht != NULL)
+	{
+		n = shash_table_seek(ht, key);
+		if (n != NULL && strcmp(n->key, key) == 0)
+			cur->node = n;
+		else
+			cur->node = n != NULL ? n->sprev : ht->stail;
+	}
+	return (cur->node != NULL);
+}
+
+/**
+ * shash_cursor_next - Moves a cursor to the next key
+ * @cur: The cursor
+ *
+ * Return: 1 if the cursor is on an element, 0 if it is past the end
+ */
+int shash_cursor_next(shash_cursor_t *cur)
+{
+	if (cur == NULL || cur->node == NULL)
+		return (0);
+
+	cur->node = cur->node->snext;
+	return (cur->node != NULL);
+}
+
+/**
+ * shash_cursor_prev - Moves a cursor to the previous key
+ * @cur: The cursor
+ *
+ * Return: 1 if the cursor is on an element, 0 if it is before the start
+ */
+int shash_cursor_prev(shash_cursor_t *cur)
+{
+	if (cur == NULL || cur->node == NULL)
+		return (0);
+
+	cur->node = cur->node->sprev;
+	return (cur->node != NULL);
+}
@@ -0,0 +1,254 @@
+#include "hash_tables.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SNAP_MAGIC "HTSNAP2"
+#define SNAP_ALIGN(n) (((n) + 7) & ~7UL)
+
+/**
+ * snap_write_chain - Writes the entries of one bucket list
+ * @f: Snapshot file, positioned at @off
+ * @ht: Pointer to the hash table
+ * @node: Head of the bucket list
+ * @off: Offset of the first entry in the file, advanced past the chain
+ *
+ * Description: Entries of a bucket are written back to back, each one
+ * holding the offset of the next.
+ * Return: 1 if it succeeded, 0 otherwise
+ */
+static int snap_write_chain(FILE *f, const hash_table_t *ht,
+			    const hash_node_t *node, unsigned long int *off)
+{
+	hash_snap_entry_t e;
+	size_t vlen, pad;
+	static const char zeros[8];
+
+	for (; node != NULL; node = node->next)
+	{
+		vlen = node->value_len;
+		pad = SNAP_ALIGN(node->key_len + vlen + 2) -
+			(node->key_len + vlen + 2);
+		*off += sizeof(e) + node->key_len + vlen + 2 + pad;
+		e.hash = node->hash;
+		e.next = node->next != NULL ? *off : 0;
+		e.key_len = node->key_len;
+		e.value_len = vlen;
+		if (fwrite(&e, sizeof(e), 1, f) != 1 ||
+		    fwrite(hash_node_key(ht, node), node->key_len + 1, 1,
+			   f) != 1 ||
+		    fwrite(hash_node_value(ht, node), vlen + 1, 1, f) != 1 ||
+		    fwrite(zeros, 1, pad, f) != pad)
+			return (0);
+	}
+	return (1);
+}
+
+/**
+ * snap_write - Writes the header, the bucket offsets and the entries
+ * @f: Snapshot file
+ * @ht: Pointer to the hash table (without a pending rehash)
+ * @buckets: Array of @ht->size offsets, filled while writing entries
+ *
+ * Return: 1 if it succeeded, 0 otherwise
+ */
+static int snap_write(FILE *f, const hash_table_t *ht,
+		      unsigned long int *buckets)
+{
+	hash_snap_header_t h;
+	unsigned long int i, off;
+
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, SNAP_MAGIC, sizeof(SNAP_MAGIC));
+	strncpy(h.hash_name, ht->hf->name, sizeof(h.hash_name) - 1);
+	h.seed = ht->seed;
+	h.index_mode = ht->index_mode;
+	h.size = ht->size;
+	h.count = ht->count;
+	off = sizeof(h) + sizeof(*buckets) * ht->size;
+	if (fseek(f, off, SEEK_SET) != 0)
+		return (0);
+	for (i = 0; i < ht->size; i++)
+	{
+		buckets[i] = ht->array[i] != NULL ? off : 0;
+		if (!snap_write_chain(f, ht, ht->array[i], &off))
+			return (0);
+	}
+	h.length = off;
+	return (fseek(f, 0, SEEK_SET) == 0 &&
+		fwrite(&h, sizeof(h), 1, f) == 1 &&
+		fwrite(buckets, sizeof(*buckets), ht->size, f) == ht->size);
+}
+
+/**
+ * hash_table_save - Saves a hash table to a snapshot file
+ * @ht: Pointer to the hash table (a pending rehash is completed first)
+ * @filename: Path of the snapshot file, created or replaced
+ *
+ * Description: The file only holds offsets, never pointers, so it can
+ * be mapped anywhere by hash_table_load_mmap(). Its integers are in the
+ * byte order of the machine that wrote it. It is written to
+ * @filename.tmp, synced, then renamed over @filename: a reader that has
+ * mapped the old file keeps it intact, and an interrupted save leaves
+ * the old file in place.
+ * Return: 1 if it succeeded, 0 otherwise
+ */
+int hash_table_save(hash_table_t *ht, const char *filename)
+{
+	unsigned long int *buckets;
+	char *tmp;
+	FILE *f = NULL;
+	int ok = 0;
+
+	if (ht == NULL || filename == NULL)
+		return (0);
+
+	hash_table_rehash_step(ht, ht->old_size);
+	buckets = malloc(sizeof(*buckets) * ht->size);
+	tmp = malloc(strlen(filename) + sizeof(".tmp"));
+	if (buckets != NULL && tmp != NULL)
+	{
+		strcpy(tmp, filename);
+		strcat(tmp, ".tmp");
+		f = fopen(tmp, "wb");
+	}
+	if (f != NULL)
+	{
+		setvbuf(f, NULL, _IOFBF, 1 << 20);
+		ok = snap_write(f, ht, buckets) && fflush(f) == 0 &&
+			fsync(fileno(f)) == 0;
+		if (fclose(f) != 0)
+			ok = 0;
+		if (!ok || rename(tmp, filename) != 0)
+		{
+			unlink(tmp);
+			ok = 0;
+		}
+	}
+	free(buckets);
+	free(tmp);
+	return (ok);
+}
+
+/**
+ * snap_hash_func - Finds the hash function named in a snapshot header
+ * @h: The header, read from the file
+ *
+ * Return: The built-in hash function, or NULL if the name is unknown or
+ *         not NUL-terminated within its field
+ */
+static const hash_func_t *snap_hash_func(const hash_snap_header_t *h)
+{
+	size_t n = sizeof(h->hash_name);
+
+	if (memchr(h->hash_name, '\0', n) == NULL)
+		return (NULL);
+	if (strncmp(h->hash_name, hash_func_djb2.name, n) == 0)
+		return (&hash_func_djb2);
+	if (strncmp(h->hash_name, hash_func_xx.name, n) == 0)
+		return (&hash_func_xx);
+	return (NULL);
+}
+
+/**
+ * hash_table_load_mmap - Maps a snapshot file for lookups
+ * @filename: Path of a file written by hash_table_save()
+ *
+ * Description: Nothing is read or copied up front; pages are brought in
+ * by the lookups that touch them. The hash function is found by name
+ * among the built-in ones.
+ * Return: A pointer to the snapshot, or NULL on failure
+ */
+hash_snapshot_t *hash_table_load_mmap(const char *filename)
+{
+	hash_snapshot_t *s;
+	struct stat st;
+	int fd;
+
+	s = filename != NULL ? malloc(sizeof(hash_snapshot_t)) : NULL;
+	fd = s != NULL ? open(filename, O_RDONLY) : -1;
+	if (fd == -1 || fstat(fd, &st) == -1 ||
+	    (size_t)st.st_size < sizeof(hash_snap_header_t))
+	{
+		if (fd != -1)
+			close(fd);
+		free(s);
+		return (NULL);
+	}
+	s->len = st.st_size;
+	s->base = mmap(NULL, s->len, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (s->base == MAP_FAILED)
+	{
+		free(s);
+		return (NULL);
+	}
+	s->header = s->base;
+	s->buckets = (const unsigned long int *)(s->header + 1);
+	s->hf = NULL;
+	if (memcmp(s->header->magic, SNAP_MAGIC, sizeof(SNAP_MAGIC)) == 0 &&
+	    s->header->length == s->len && s->header->size != 0 &&
+	    s->header->size <= (s->len - sizeof(hash_snap_header_t)) / 8)
+		s->hf = snap_hash_func(s->header);
+	if (s->hf == NULL)
+	{
+		hash_snapshot_close(s);
+		return (NULL);
+	}
+	return (s);
+}
+
+/**
+ * hash_snapshot_get - Retrieves a value from a mapped snapshot
+ * @s: Pointer to the snapshot
+ * @key: The key you are looking for
+ *
+ * Description: Entries are checked to lie within the mapping, aligned
+ * and in file order before they are read, so a corrupt offset or length
+ * ends the lookup instead of reading past the mapping or looping.
+ * Return: The value associated with the key, pointing into the mapping,
+ *         or NULL if the key couldn't be found
+ */
+const char *hash_snapshot_get(const hash_snapshot_t *s, const char *key)
+{
+	const hash_snap_entry_t *e;
+	unsigned long int hash, off, room;
+	size_t len;
+
+	if (s == NULL || key == NULL || *key == '\0')
+		return (NULL);
+
+	len = strlen(key);
+	hash = s->hf->hash(key, len, s->header->seed);
+	off = s->buckets[hash_index(hash, s->header->size,
+				    s->header->index_mode)];
+	while (off != 0 && off % 8 == 0 && off <= s->len - sizeof(*e))
+	{
+		e = (const hash_snap_entry_t *)((const char *)s->base + off);
+		room = s->len - off - sizeof(*e);
+		if (e->key_len > room || e->value_len > room - e->key_len ||
+		    room - e->key_len - e->value_len < 2)
+			return (NULL);
+		if (e->hash == hash && e->key_len == len &&
+		    memcmp(e + 1, key, len) == 0)
+			return ((const char *)(e + 1) + len + 1);
+		if (e->next != 0 && e->next <= off)
+			return (NULL);
+		off = e->next;
+	}
+	return (NULL);
+}
+
+/**
+ * hash_snapshot_close - Unmaps a snapshot
+ * @s: Pointer to the snapshot (may be NULL)
+ */
+void hash_snapshot_close(hash_snapshot_t *s)
+{
+	if (s == NULL)
+		return;
+
+	munmap(s->base, s->len);
+	free(s);
+}
@@ -0,0 +1,178 @@
+#include "hash_tables.h"
+
+/**
+ * visit_buckets - Visits every node of an array of bucket lists
+ * @ht: Pointer to the hash table
+ * @array: Array of bucket lists (may be NULL)
+ * @size: The size of @array
+ * @visit: Called on each element
+ * @data: Passed to @visit
+ *
+ * Return: 0 if every element was visited, or what @visit returned
+ *         when it stopped the iteration
+ */
+static int visit_buckets(const hash_table_t *ht, hash_node_t **array,
+			 unsigned long int size, hash_visit_t visit,
+			 void *data)
+{
+	unsigned long int i;
+	hash_node_t *node;
+	int ret;
+
+	for (i = 0; array != NULL && i < size; i++)
+	{
+		for (node = array[i]; node != NULL; node = node->next)
+		{
+			ret = visit(hash_node_key(ht, node),
+				    hash_node_value(ht, node), data);
+			if (ret != 0)
+				return (ret);
+		}
+	}
+	return (0);
+}
+
+/**
+ * hash_table_foreach - Visits every element of a hash table
+ * @ht: Pointer to the hash table
+ * @visit: Called on each element, in the order of hash_table_print()
+ * @data: Passed to @visit
+ *
+ * Description: Nothing is allocated. @visit must not modify the table.
+ * Return: 0 if every element was visited, or what @visit returned
+ *         when it stopped the iteration
+ */
+int hash_table_foreach(const hash_table_t *ht, hash_visit_t visit,
+		       void *data)
+{
+	int ret;
+
+	if (ht == NULL || visit == NULL)
+		return (0);
+
+	ret = visit_buckets(ht, ht->array, ht->size, visit, data);
+	if (ret != 0)
+		return (ret);
+	return (visit_buckets(ht, ht->old_array, ht->old_size, visit, data));
+}
+
+/**
+ * rev_bits - Reverses the bits of an unsigned long int
+ * @v: Value to reverse
+ *
+ * Return: @v with its bits in reverse order
+ */
+static unsigned long int rev_bits(unsigned long int v)
+{
+	unsigned long int r = 0;
+	unsigned int i;
+
+	for (i = 0; i < sizeof(v) * 8; i++)
+	{
+		r = (r << 1) | (v & 1);
+		v >>= 1;
+	}
+	return (r);
+}
+
+/**
+ * scan_bucket - Visits the elements of one bucket list
+ * @ht: Pointer to the hash table
+ * @node: Head of the bucket list
+ * @visit: Called on each element
+ * @data: Passed to @visit
+ */
+static void scan_bucket(const hash_table_t *ht, const hash_node_t *node,
+			hash_visit_t visit, void *data)
+{
+	for (; node != NULL; node = node->next)
+		visit(hash_node_key(ht, node), hash_node_value(ht, node), data);
+}
+
+/**
+ * scan_arrays - Picks the smaller and larger bucket arrays of a scan
+ * @ht: Pointer to the hash table
+ * @base: Odd factor of the bucket counts of @ht
+ * @small: Receives the smaller array
+ * @m0: Receives the mask of the split bits of @small
+ * @m1: Receives the mask of the split bits of the larger array
+ *
+ * Return: The larger array while a rehash is pending, NULL otherwise
+ */
+static hash_node_t **scan_arrays(const hash_table_t *ht,
+				 unsigned long int base, hash_node_t ***small,
+				 unsigned long int *m0, unsigned long int *m1)
+{
+	hash_node_t **large = NULL;
+
+	*small = ht->array;
+	*m0 = ht->size / base - 1;
+	*m1 = 0;
+	if (ht->old_array == NULL)
+		return (NULL);
+	large = ht->array;
+	*m1 = ht->size / base - 1;
+	*small = ht->old_array;
+	*m0 = ht->old_size / base - 1;
+	if (*m0 > *m1)
+	{
+		large = ht->old_array;
+		*small = ht->array;
+		*m1 = *m0;
+		*m0 = ht->size / base - 1;
+	}
+	return (large);
+}
+
+/**
+ * hash_table_scan - Visits the next bucket of a resumable scan
+ * @ht: Pointer to the hash table (HT_INDEX_MOD or HT_INDEX_MASK mode)
+ * @cur: Cursor, zeroed before the first call
+ * @visit: Called on each element of the bucket
+ * @data: Passed to @visit
+ *
+ * Description: The table may be modified between calls, and grow. A
+ * table of base * 2^k buckets (base odd, which doubling keeps) puts a
+ * hash in bucket r + base * t, where growing only adds high bits to t.
+ * The cursor, r + base * t for a bucket of the smaller array, walks t in
+ * bit-reversed order, so buckets already visited stay behind it when
+ * the table grows. While a rehash is pending, the bucket of the smaller
+ * array is visited along with every bucket of the larger one that it
+ * splits into; the rehash is left to run at its own pace. Every element
+ * present during the whole scan is visited at least once; some may be
+ * visited more than once.
+ * Return: 1 while buckets remain, 0 once the scan is complete,
+ *         -1 if @ht indexes its buckets with HT_INDEX_FASTRANGE
+ */
+int hash_table_scan(const hash_table_t *ht, hash_cursor_t *cur,
+		    hash_visit_t visit, void *data)
+{
+	hash_node_t **small, **large;
+	unsigned long int base, m0, m1, r, v;
+
+	if (ht == NULL || cur == NULL || visit == NULL)
+		return (0);
+	if (ht->index_mode == HT_INDEX_FASTRANGE)
+		return (-1);
+
+	base = ht->size / (ht->size & -ht->size);
+	large = scan_arrays(ht, base, &small, &m0, &m1);
+	r = cur->pos % base;
+	v = cur->pos / base;
+	scan_bucket(ht, small[r + base * (v & m0)], visit, data);
+	if (large != NULL)
+	{
+		do {
+			scan_bucket(ht, large[r + base * (v & m1)], visit,
+				    data);
+			v = (((v | m0) + 1) & ~m0) | (v & m0);
+		} while (v & (m0 ^ m1));
+	}
+	if (r + 1 < base)
+	{
+		cur->pos = r + 1 + base * (v & m0);
+		return (1);
+	}
+	cur->pos = base * rev_bits(rev_bits(v | ~m0) + 1);
+	return (cur->pos != 0);
+}
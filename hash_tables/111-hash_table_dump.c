@@ -0,0 +1,225 @@
+#include "hash_tables.h"
+#include <unistd.h>
+
+#define DUMP_BUFSIZE 65536
+
+/**
+ * struct dump_s - Output of a dump
+ * @fd: File descriptor flushed to, or -1 when dumping to @out
+ * @out: Caller's buffer, or the staging buffer when dumping to @fd
+ * @cap: Size of @out
+ * @len: Number of bytes currently in @out
+ * @total: Number of bytes produced so far
+ * @format: HT_DUMP_DICT, HT_DUMP_JSON or HT_DUMP_CSV
+ * @first: Nonzero until the first element has been written
+ * @err: Nonzero once a write to @fd has failed
+ */
+typedef struct dump_s
+{
+	int fd;
+	char *out;
+	size_t cap;
+	size_t len;
+	size_t total;
+	int format;
+	int first;
+	int err;
+} dump_t;
+
+/**
+ * dump_flush - Writes the staged bytes of a dump to its file descriptor
+ * @d: The dump
+ */
+static void dump_flush(dump_t *d)
+{
+	size_t done = 0;
+	ssize_t w;
+
+	while (d->fd != -1 && !d->err && done < d->len)
+	{
+		w = write(d->fd, d->out + done, d->len - done);
+		if (w == -1)
+			d->err = 1;
+		else
+			done += w;
+	}
+	if (d->fd != -1)
+		d->len = 0;
+}
+
+/**
+ * dump_put - Appends bytes to a dump
+ * @d: The dump
+ * @s: Bytes to append
+ * @n: Number of bytes
+ *
+ * Description: Bytes beyond the capacity of a caller's buffer are only
+ * counted, so the caller learns the size it needs.
+ */
+static void dump_put(dump_t *d, const char *s, size_t n)
+{
+	size_t k;
+
+	d->total += n;
+	while (n > 0)
+	{
+		if (d->len == d->cap)
+		{
+			if (d->fd == -1)
+				return;
+			dump_flush(d);
+		}
+		k = d->cap - d->len < n ? d->cap - d->len : n;
+		memcpy(d->out + d->len, s, k);
+		d->len += k;
+		s += k;
+		n -= k;
+	}
+}
+
+/**
+ * dump_str - Appends a string, quoted for the format of a dump
+ * @d: The dump
+ * @s: The string
+ *
+ * Description: JSON escapes quotes, backslashes and control characters;
+ * CSV quotes fields holding a separator, a quote or a line break.
+ */
+static void dump_str(dump_t *d, const char *s)
+{
+	static const char hex[] = "0123456789abcdef";
+	char esc[6] = {'\\', 'u', '0', '0', 0, 0};
+	const char *dq = d->format == HT_DUMP_JSON ? "\\\"" : "\"\"";
+	int quote;
+
+	if (d->format == HT_DUMP_DICT)
+	{
+		dump_put(d, "'", 1);
+		dump_put(d, s, strlen(s));
+		dump_put(d, "'", 1);
+		return;
+	}
+	quote = d->format == HT_DUMP_JSON || strpbrk(s, ",\"\r\n") != NULL;
+	if (quote)
+		dump_put(d, "\"", 1);
+	for (; *s != '\0'; s++)
+	{
+		if (*s == '"')
+			dump_put(d, dq, 2);
+		else if (d->format == HT_DUMP_JSON && *s == '\\')
+			dump_put(d, "\\\\", 2);
+		else if (d->format == HT_DUMP_JSON && (unsigned char)*s < 0x20)
+		{
+			esc[4] = hex[(unsigned char)*s >> 4];
+			esc[5] = hex[*s & 0xf];
+			dump_put(d, esc, 6);
+		}
+		else
+			dump_put(d, s, 1);
+	}
+	if (quote)
+		dump_put(d, "\"", 1);
+}
+
+/**
+ * dump_visit - Appends one element to a dump
+ * @key: Key of the element
+ * @value: Value of the element
+ * @data: The dump
+ *
+ * Return: Always 0
+ */
+static int dump_visit(const char *key, const char *value, void *data)
+{
+	dump_t *d = data;
+
+	if (d->format != HT_DUMP_CSV && !d->first)
+		dump_put(d, ", ", 2);
+	d->first = 0;
+	dump_str(d, key);
+	if (d->format == HT_DUMP_CSV)
+		dump_put(d, ",", 1);
+	else
+		dump_put(d, ": ", 2);
+	dump_str(d, value);
+	if (d->format == HT_DUMP_CSV)
+		dump_put(d, "\n", 1);
+	return (0);
+}
+
+/**
+ * dump_table - Produces the whole dump of a hash table
+ * @ht: Pointer to the hash table
+ * @d: The dump
+ */
+static void dump_table(const hash_table_t *ht, dump_t *d)
+{
+	d->first = 1;
+	if (d->format == HT_DUMP_CSV)
+		dump_put(d, "key,value\n", 10);
+	else
+		dump_put(d, "{", 1);
+	hash_table_foreach(ht, dump_visit, d);
+	if (d->format != HT_DUMP_CSV)
+		dump_put(d, "}\n", 2);
+}
+
+/**
+ * hash_table_dump - Writes a hash table to a file descriptor
+ * @ht: Pointer to the hash table
+ * @fd: File descriptor to write to
+ * @format: HT_DUMP_DICT (the format of hash_table_print()), HT_DUMP_JSON
+ *          or HT_DUMP_CSV (with a "key,value" header line)
+ *
+ * Description: Output is staged in a 64 KiB buffer on the stack and
+ * written in large blocks; nothing is allocated.
+ * Return: Number of bytes written, or -1 on failure
+ */
+long hash_table_dump(const hash_table_t *ht, int fd, int format)
+{
+	char buf[DUMP_BUFSIZE];
+	dump_t d;
+
+	if (ht == NULL || fd < 0 || format < HT_DUMP_DICT ||
+	    format > HT_DUMP_CSV)
+		return (-1);
+
+	memset(&d, 0, sizeof(d));
+	d.fd = fd;
+	d.out = buf;
+	d.cap = sizeof(buf);
+	d.format = format;
+	dump_table(ht, &d);
+	dump_flush(&d);
+	return (d.err ? -1 : (long)d.total);
+}
+
+/**
+ * hash_table_dump_buf - Writes a hash table to a buffer
+ * @ht: Pointer to the hash table
+ * @buf: Buffer to write to (may be NULL if @size is 0)
+ * @size: Size of @buf
+ * @format: Same as for hash_table_dump()
+ *
+ * Description: Like snprintf(), output is truncated to fit in @buf,
+ * which is NUL-terminated whenever @size isn't 0.
+ * Return: Length of the whole dump, not counting the terminating NUL
+ */
+size_t hash_table_dump_buf(const hash_table_t *ht, char *buf, size_t size,
+			   int format)
+{
+	dump_t d;
+
+	if (ht == NULL || format < HT_DUMP_DICT || format > HT_DUMP_CSV)
+		return (0);
+
+	memset(&d, 0, sizeof(d));
+	d.fd = -1;
+	d.out = buf;
+	d.cap = size != 0 ? size - 1 : 0;
+	d.format = format;
+	dump_table(ht, &d);
+	if (size != 0)
+		buf[d.len] = '\0';
+	return (d.total);
+}
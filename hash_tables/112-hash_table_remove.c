@@ -0,0 +1,84 @@
+#include "hash_tables.h"
+
+/**
+ * hash_table_flush_removed - Frees the nodes whose freeing was deferred
+ * @ht: Pointer to the hash table
+ */
+void hash_table_flush_removed(hash_table_t *ht)
+{
+	hash_node_t *node, *tmp;
+
+	if (ht == NULL)
+		return;
+
+	node = ht->removed;
+	while (node != NULL)
+	{
+		tmp = node->next;
+		hash_node_free(ht, node);
+		node = tmp;
+	}
+	ht->removed = NULL;
+	ht->removed_count = 0;
+}
+
+/**
+ * hash_table_remove - Removes an element from a hash table
+ * @ht: Pointer to the hash table
+ * @key: The key of the element
+ *
+ * Description: The node is unlinked from its bucket list, so no
+ * tombstone is left behind. If the table was created with a defer_free
+ * option, freed nodes are kept aside and released that many at a time;
+ * the value returned by an earlier hash_table_get() stays valid until
+ * then.
+ * Return: 1 if the element was removed, 0 if it wasn't in the table
+ */
+int hash_table_remove(hash_table_t *ht, const char *key)
+{
+	if (key == NULL)
+		return (0);
+	return (hash_table_remove_bin(ht, key, strlen(key)));
+}
+
+/**
+ * hash_table_remove_bin - Removes an element with a binary key
+ * @ht: Pointer to the hash table
+ * @key: The key bytes
+ * @klen: Length of @key
+ *
+ * Description: Same as hash_table_remove().
+ * Return: 1 if the element was removed, 0 if it wasn't in the table
+ */
+int hash_table_remove_bin(hash_table_t *ht, const void *key, size_t klen)
+{
+	hash_node_t **pp, *node;
+	unsigned long int hash;
+
+	if (ht == NULL || key == NULL || klen == 0)
+		return (0);
+
+	hash = hash_table_hash(ht, key, klen);
+	pp = hash_table_bucket(ht, hash);
+	node = hash_chain_find(ht, *pp, key, klen, hash);
+	if (node == NULL)
+		return (0);
+	while (*pp != node)
+		pp = &(*pp)->next;
+	*pp = node->next;
+	ht->count--;
+	HT_COUNT(ht, removes);
+	if (ht->bloom != NULL && ++ht->bloom->stale > ht->bloom->keys / 2)
+		hash_bloom_rebuild(ht, ht->bloom->capacity);
+
+	if (ht->defer_free == 0)
+	{
+		hash_node_free(ht, node);
+		return (1);
+	}
+	node->next = ht->removed;
+	ht->removed = node;
+	if (++ht->removed_count >= ht->defer_free)
+		hash_table_flush_removed(ht);
+	return (1);
+}
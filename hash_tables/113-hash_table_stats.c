@@ -0,0 +1,98 @@
+#include "hash_tables.h"
+
+/**
+ * stats_buckets - Accounts for the bucket lists of an array
+ * @ht: Pointer to the hash table
+ * @array: Array of bucket lists (may be NULL)
+ * @size: The size of @array
+ * @st: Statistics being gathered
+ * @probes: Sum of the probe lengths of every element, increased
+ */
+static void stats_buckets(const hash_table_t *ht, hash_node_t **array,
+			  unsigned long int size, hash_stats_t *st,
+			  double *probes)
+{
+	unsigned long int i, len;
+	hash_node_t *node;
+
+	st->memory += sizeof(hash_node_t *) * size;
+	for (i = 0; array != NULL && i < size; i++)
+	{
+		len = 0;
+		for (node = array[i]; node != NULL; node = node->next)
+		{
+			len++;
+			*probes += len;
+			if (ht->arena == NULL)
+				st->memory += hash_node_size(ht, node);
+		}
+		st->hist[len < HT_STATS_HIST ? len : HT_STATS_HIST - 1]++;
+		st->used_buckets += len != 0;
+		if (len > st->max_probe)
+			st->max_probe = len;
+	}
+}
+
+/**
+ * hash_table_stats - Gathers statistics about a hash table
+ * @ht: Pointer to the hash table
+ * @st: Receives the statistics
+ *
+ * Description: Walks every bucket, so it costs O(size + count); the
+ * operation counters themselves are only bumped by each operation.
+ * Buckets of a pending rehash are counted with the new ones.
+ * Return: 1 if it succeeded, 0 otherwise
+ */
+int hash_table_stats(const hash_table_t *ht, hash_stats_t *st)
+{
+	const hash_slab_t *s;
+	double probes = 0;
+
+	if (ht == NULL || st == NULL)
+		return (0);
+
+	memset(st, 0, sizeof(*st));
+	st->size = ht->size;
+	st->count = ht->count;
+	st->load_factor = (double)ht->count / ht->size;
+	st->memory = sizeof(hash_table_t);
+	stats_buckets(ht, ht->array, ht->size, st, &probes);
+	stats_buckets(ht, ht->old_array, ht->old_size, st, &probes);
+	for (s = ht->arena != NULL ? ht->arena->slabs : NULL; s; s = s->next)
+		st->memory += sizeof(hash_slab_t) + s->size;
+	if (ht->counters != NULL)
+	{
+		st->ops = *ht->counters;
+		st->memory += sizeof(hash_counters_t);
+	}
+	if (ht->count != 0)
+		st->mean_probe = probes / ht->count;
+	return (1);
+}
+
+/**
+ * hash_stats_print - Prints statistics gathered by hash_table_stats()
+ * @st: The statistics
+ */
+void hash_stats_print(const hash_stats_t *st)
+{
+	int i;
+
+	if (st == NULL)
+		return;
+
+	printf("size: %lu, count: %lu, load factor: %.2f\n",
+	       st->size, st->count, st->load_factor);
+	printf("used buckets: %lu, max probe: %lu, mean probe: %.2f\n",
+	       st->used_buckets, st->max_probe, st->mean_probe);
+	printf("memory: %lu bytes\n", (unsigned long int)st->memory);
+	printf("chain lengths:");
+	for (i = 0; i < HT_STATS_HIST; i++)
+		printf(" %d%s: %lu", i, i == HT_STATS_HIST - 1 ? "+" : "",
+		       st->hist[i]);
+	printf("\n");
+	printf("inserts: %lu, updates: %lu, collisions: %lu\n",
+	       st->ops.inserts, st->ops.updates, st->ops.collisions);
+	printf("get hits: %lu, get misses: %lu, removes: %lu\n",
+	       st->ops.get_hits, st->ops.get_misses, st->ops.removes);
+}
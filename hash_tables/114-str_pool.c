@@ -0,0 +1,185 @@
+#include "hash_tables.h"
+
+/**
+ * str_pool_create - Creates a string interning pool
+ * @size: Initial number of buckets (the pool grows as needed)
+ *
+ * Return: A pointer to the new pool, or NULL on failure
+ */
+str_pool_t *str_pool_create(unsigned long int size)
+{
+	str_pool_t *p;
+
+	size = hash_pow2(size != 0 ? size : 1);
+	if (size == 0)
+		return (NULL);
+	p = malloc(sizeof(str_pool_t));
+	if (p == NULL)
+		return (NULL);
+	p->array = calloc(size, sizeof(str_pool_entry_t *));
+	if (p->array == NULL)
+	{
+		free(p);
+		return (NULL);
+	}
+	p->size = size;
+	p->count = 0;
+	return (p);
+}
+
+/**
+ * pool_bucket - Finds the bucket list of a string in a pool
+ * @p: The pool
+ * @hash: hash_xx() of the string
+ *
+ * Return: Pointer to the head of the bucket list
+ */
+static str_pool_entry_t **pool_bucket(const str_pool_t *p,
+				      unsigned long int hash)
+{
+	return (&p->array[hash_index(hash, p->size, HT_INDEX_MASK)]);
+}
+
+/**
+ * str_pool_find - Looks a string up in a pool, without referencing it
+ * @p: The pool
+ * @s: The string
+ * @len: Length of @s
+ *
+ * Return: The interned copy of @s, or NULL if @s isn't in the pool
+ */
+const char *str_pool_find(const str_pool_t *p, const char *s, size_t len)
+{
+	unsigned long int hash = hash_xx(s, len, 0);
+	str_pool_entry_t *e;
+
+	for (e = *pool_bucket(p, hash); e != NULL; e = e->next)
+	{
+		if (e->hash == hash && e->len == len &&
+		    memcmp(e + 1, s, len) == 0)
+			return ((const char *)(e + 1));
+	}
+	return (NULL);
+}
+
+/**
+ * pool_grow - Doubles the number of buckets of a pool
+ * @p: The pool
+ *
+ * Description: A pool that can't grow keeps working, only slower.
+ */
+static void pool_grow(str_pool_t *p)
+{
+	str_pool_t old = *p;
+	str_pool_entry_t *e, *tmp, **bucket;
+	unsigned long int i;
+
+	p->array = calloc(old.size * 2, sizeof(str_pool_entry_t *));
+	if (p->array == NULL)
+	{
+		*p = old;
+		return;
+	}
+	p->size = old.size * 2;
+	for (i = 0; i < old.size; i++)
+	{
+		for (e = old.array[i]; e != NULL; e = tmp)
+		{
+			tmp = e->next;
+			bucket = pool_bucket(p, e->hash);
+			e->next = *bucket;
+			*bucket = e;
+		}
+	}
+	free(old.array);
+}
+
+/**
+ * str_pool_intern - Gets the shared copy of a string, taking a reference
+ * @p: The pool
+ * @s: The string
+ * @len: Length of @s
+ *
+ * Description: Two strings interned in the same pool are equal if and
+ * only if the pointers returned for them are equal.
+ * Return: The interned copy of @s (to be given back with
+ *         str_pool_release()), or NULL on failure
+ */
+const char *str_pool_intern(str_pool_t *p, const char *s, size_t len)
+{
+	unsigned long int hash = hash_xx(s, len, 0);
+	str_pool_entry_t *e, **bucket;
+
+	bucket = pool_bucket(p, hash);
+	for (e = *bucket; e != NULL; e = e->next)
+	{
+		if (e->hash == hash && e->len == len &&
+		    memcmp(e + 1, s, len) == 0)
+		{
+			e->refs++;
+			return ((const char *)(e + 1));
+		}
+	}
+
+	e = malloc(sizeof(str_pool_entry_t) + len + 1);
+	if (e == NULL)
+		return (NULL);
+	e->hash = hash;
+	e->len = len;
+	e->refs = 1;
+	memcpy(e + 1, s, len);
+	((char *)(e + 1))[len] = '\0';
+	e->next = *bucket;
+	*bucket = e;
+	if (++p->count > p->size)
+		pool_grow(p);
+	return ((const char *)(e + 1));
+}
+
+/**
+ * str_pool_release - Gives back a reference taken by str_pool_intern()
+ * @p: The pool
+ * @s: The interned string
+ *
+ * Description: The string is freed with its last reference.
+ */
+void str_pool_release(str_pool_t *p, const char *s)
+{
+	str_pool_entry_t *e = (str_pool_entry_t *)s - 1, **pp;
+
+	if (--e->refs != 0)
+		return;
+
+	pp = pool_bucket(p, e->hash);
+	while (*pp != e)
+		pp = &(*pp)->next;
+	*pp = e->next;
+	p->count--;
+	free(e);
+}
+
+/**
+ * str_pool_delete - Deletes a pool and every string left in it
+ * @p: The pool (may be NULL)
+ *
+ * Description: Tables using the pool must be deleted first.
+ */
+void str_pool_delete(str_pool_t *p)
+{
+	str_pool_entry_t *e, *tmp;
+	unsigned long int i;
+
+	if (p == NULL)
+		return;
+
+	for (i = 0; i < p->size; i++)
+	{
+		for (e = p->array[i]; e != NULL; e = tmp)
+		{
+			tmp = e->next;
+			free(e);
+		}
+	}
+	free(p->array);
+	free(p);
+}
@@ -0,0 +1,197 @@
+#include "hash_tables.h"
+
+#define BLOOM_WORDS 8 /* 64-bit words per block: one 64-byte cache line */
+
+/**
+ * bloom_bits - Derives the block and the bit positions of a key
+ * @b: The filter
+ * @hash: Hash of the key
+ * @bits: Receives the @b->k bit positions, in [0, 512)
+ *
+ * Return: Pointer to the block of the key
+ */
+static unsigned long int *bloom_bits(const hash_bloom_t *b,
+				     unsigned long int hash,
+				     unsigned int *bits)
+{
+	unsigned long int h1 = hash_mix(hash), h2 = hash_mix(~hash);
+	unsigned int i;
+
+	for (i = 0; i < b->k; i++)
+	{
+		bits[i] = h2 & 511;
+		h2 >>= 9;
+	}
+	return (b->blocks + (h1 & (b->nblocks - 1)) * BLOOM_WORDS);
+}
+
+/**
+ * hash_bloom_add - Records a key in the filter of a table
+ * @ht: Pointer to the hash table
+ * @hash: Hash of the key
+ *
+ * Description: Once the filter holds more keys than it was sized for,
+ * it is rebuilt twice as large from the keys of the table, which already
+ * holds the new one. If that fails, the key is added to the current
+ * filter anyway: its false positive rate rises, but a key of the table
+ * is never reported absent.
+ */
+void hash_bloom_add(hash_table_t *ht, unsigned long int hash)
+{
+	hash_bloom_t *b = ht->bloom;
+	unsigned long int *block;
+	unsigned int bits[BLOOM_MAX_K], i;
+
+	if (b == NULL)
+		return;
+	if (b->keys >= b->capacity && hash_bloom_rebuild(ht, b->capacity * 2))
+		return;
+	block = bloom_bits(b, hash, bits);
+	for (i = 0; i < b->k; i++)
+		block[bits[i] / 64] |= 1UL << (bits[i] % 64);
+	b->keys++;
+}
+
+/**
+ * hash_bloom_test - Checks whether a key may be in a table
+ * @ht: Pointer to the hash table (which has a filter)
+ * @hash: Hash of the key
+ *
+ * Description: Reads a single cache line.
+ * Return: 0 if the key is definitely absent, 1 if it may be present
+ */
+int hash_bloom_test(const hash_table_t *ht, unsigned long int hash)
+{
+	hash_bloom_t *b = ht->bloom;
+	unsigned long int *block;
+	unsigned int bits[BLOOM_MAX_K], i;
+
+	block = bloom_bits(b, hash, bits);
+	for (i = 0; i < b->k; i++)
+	{
+		if (!(block[bits[i] / 64] & (1UL << (bits[i] % 64))))
+		{
+			b->negatives++;
+			return (0);
+		}
+	}
+	b->positives++;
+	return (1);
+}
+
+/**
+ * hash_bloom_rebuild - Rebuilds the filter of a table from its elements
+ * @ht: Pointer to the hash table
+ * @capacity: Number of keys to size the filter for (at least the count)
+ *
+ * Description: Needed after removals, which a Bloom filter can't undo:
+ * removed keys keep answering "maybe" until the filter is rebuilt.
+ * Return: 1 if it succeeded, 0 otherwise (the old filter is kept)
+ */
+int hash_bloom_rebuild(hash_table_t *ht, unsigned long int capacity)
+{
+	hash_bloom_t *b = ht->bloom;
+	hash_node_t **arrays[2], *node;
+	unsigned long int sizes[2], i, n, *blocks;
+	int a;
+
+	if (capacity < ht->count)
+		capacity = ht->count;
+	n = hash_pow2((capacity * b->bits_per_key + 511) / 512);
+	if (n == 0 || posix_memalign((void **)&blocks, 64,
+				     n * BLOOM_WORDS * sizeof(*blocks)) != 0)
+		return (0);
+	memset(blocks, 0, n * BLOOM_WORDS * sizeof(*blocks));
+	free(b->blocks);
+	b->blocks = blocks;
+	b->nblocks = n;
+	b->capacity = n * 512 / b->bits_per_key;
+	b->keys = 0;
+	b->stale = 0;
+	arrays[0] = ht->array;
+	sizes[0] = ht->size;
+	arrays[1] = ht->old_array;
+	sizes[1] = ht->old_array != NULL ? ht->old_size : 0;
+	for (a = 0; a < 2; a++)
+		for (i = 0; i < sizes[a]; i++)
+			for (node = arrays[a][i]; node; node = node->next)
+				hash_bloom_add(ht, node->hash);
+	return (1);
+}
+
+/**
+ * hash_table_bloom_enable - Puts a Bloom filter in front of lookups
+ * @ht: Pointer to the hash table
+ * @bits_per_key: Filter bits per key (e.g. 10 for about 1% false
+ *                positives), or 0 to remove the filter
+ *
+ * Description: The filter is a blocked Bloom filter: all the bits of a
+ * key fall in one 64-byte block. It is kept up to date by set and
+ * remove, and rebuilt once half of its keys have been removed.
+ * Return: 1 if it succeeded, 0 otherwise
+ */
+int hash_table_bloom_enable(hash_table_t *ht, unsigned int bits_per_key)
+{
+	hash_bloom_t *b;
+
+	if (ht == NULL)
+		return (0);
+	if (ht->bloom != NULL)
+		free(ht->bloom->blocks);
+	free(ht->bloom);
+	ht->bloom = NULL;
+	if (bits_per_key == 0)
+		return (1);
+
+	b = calloc(1, sizeof(hash_bloom_t));
+	if (b == NULL)
+		return (0);
+	b->bits_per_key = bits_per_key;
+	b->k = (unsigned int)(bits_per_key * 0.69 + 0.5);
+	if (b->k < 1)
+		b->k = 1;
+	if (b->k > BLOOM_MAX_K)
+		b->k = BLOOM_MAX_K;
+	ht->bloom = b;
+	if (!hash_bloom_rebuild(ht, ht->size > ht->count ? ht->size : 0))
+	{
+		free(b);
+		ht->bloom = NULL;
+		return (0);
+	}
+	return (1);
+}
+
+/**
+ * hash_table_bloom_fpr - Reports the false positive rate of the filter
+ * @ht: Pointer to the hash table
+ * @measured: If not NULL, receives the rate observed so far: the share
+ *            of lookups of absent keys that the filter let through
+ *
+ * Description: The expected rate is the share of bits set, to the power
+ * of the number of bits per key; it accounts for stale keys.
+ * Return: The expected rate, or -1 if @ht has no filter
+ */
+double hash_table_bloom_fpr(const hash_table_t *ht, double *measured)
+{
+	const hash_bloom_t *b;
+	unsigned long int absent, set = 0, i;
+	double fill, rate = 1;
+	unsigned int k;
+
+	if (ht == NULL || ht->bloom == NULL)
+		return (-1);
+
+	b = ht->bloom;
+	if (measured != NULL)
+	{
+		absent = b->negatives + b->false_positives;
+		*measured = absent ? (double)b->false_positives / absent : 0;
+	}
+	for (i = 0; i < b->nblocks * BLOOM_WORDS; i++)
+		set += __builtin_popcountl(b->blocks[i]);
+	fill = (double)set / (b->nblocks * 512);
+	for (k = 0; k < b->k; k++)
+		rate *= fill;
+	return (rate);
+}
@@ -10,5 +10,43 @@
  */
 unsigned long int key_index(const unsigned char *key, unsigned long int size)
 {
-	return (hash_djb2(key) % size);
+	return (hash_index(hash_djb2(key), size, HT_INDEX_MOD));
+}
+
+/**
+ * hash_index - Gives the index of an already hashed key
+ * @hash: The hash of the key
+ * @size: The size of the array of the hash table
+ * @mode: HT_INDEX_MOD, HT_INDEX_MASK (@size must be a power of two)
+ *        or HT_INDEX_FASTRANGE
+ *
+ * Description: Both HT_INDEX_MASK and HT_INDEX_FASTRANGE avoid the
+ * 64-bit division of HT_INDEX_MOD. Fastrange maps the high 32 bits of the
+ * mixed hash onto [0, size) with a multiply and a shift, so it needs
+ * @size to fit in 32 bits; larger arrays fall back to a modulo.
+ * Return: The index at which the key/value pair should
+ *         be stored in the array of the hash table
+ */
+unsigned long int hash_index(unsigned long int hash, unsigned long int size,
+			     int mode)
+{
+	if (mode == HT_INDEX_MASK)
+		return (hash_mix(hash) & (size - 1));
+	if (mode == HT_INDEX_FASTRANGE && size <= 0xffffffffUL)
+		return (((hash_mix(hash) >> 32) * size) >> 32);
+	return (hash % size);
+}
+
+/**
+ * hash_table_hash - Hashes a key with the hash function of a table
+ * @ht: Pointer to the hash table
+ * @key: The key
+ * @len: Length of @key
+ *
+ * Return: The hash of @key
+ */
+unsigned long int hash_table_hash(const hash_table_t *ht, const char *key,
+				  size_t len)
+{
+	return (ht->hf->hash(key, len, ht->seed));
 }
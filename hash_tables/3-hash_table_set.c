@@ -1,102 +1,122 @@
 #include "hash_tables.h"
 
 /**
- * node_create - Creates a new hash node (key/value duplicated)
- * @key: Key string (non-empty)
- * @value: Value string
+ * update_if_exists - Updates node value if key exists in the table
+ * @ht: Pointer to the hash table
+ * @key: Key to search
+ * @len: Length of @key
+ * @hash: The hash of @key
+ * @value: New value (will be duplicated)
+ * @vlen: Length of @value
  *
- * Return: Pointer to new node, or NULL on failure
+ * Return: 1 if updated, 0 if not found, -1 on failure
  */
-static hash_node_t *node_create(const char *key, const char *value)
+static int update_if_exists(hash_table_t *ht, const char *key, size_t len,
+			    unsigned long int hash, const char *value,
+			    size_t vlen)
 {
-	hash_node_t *node;
+	hash_node_t *node, **link;
 
-	node = malloc(sizeof(hash_node_t));
+	node = hash_table_find(ht, key, len, hash);
 	if (node == NULL)
-		return (NULL);
-
-	node->key = strdup(key);
-	if (node->key == NULL)
-	{
-		free(node);
-		return (NULL);
-	}
+		return (0);
 
-	node->value = strdup(value);
-	if (node->value == NULL)
-	{
-		free(node->key);
-		free(node);
-		return (NULL);
-	}
+	link = hash_table_bucket(ht, hash);
+	while (*link != node)
+		link = &(*link)->next;
+	if (!hash_node_set_value(ht, link, value, vlen))
+		return (-1);
+	return (1);
+}
 
-	node->next = NULL;
-	return (node);
+/**
+ * hash_table_set - Adds or updates an element in a hash table
+ * @ht: Pointer to the hash table
+ * @key: The key (cannot be an empty string)
+ * @value: The value associated with the key (will be duplicated)
+ *
+ * Description: The table grows once it holds more elements than buckets.
+ * Return: 1 if it succeeded, 0 otherwise
+ */
+int hash_table_set(hash_table_t *ht, const char *key, const char *value)
+{
+	if (key == NULL || value == NULL)
+		return (0);
+	return (hash_table_set_bin(ht, key, strlen(key), value, strlen(value)));
 }
 
 /**
- * update_if_exists - Updates node value if key exists in a chain
- * @head: Head of chain
- * @key: Key to search
- * @value: New value (will be duplicated)
+ * hash_table_set_bin - Adds or updates an element with binary key/value
+ * @ht: Pointer to the hash table
+ * @key: The key bytes
+ * @klen: Length of @key (cannot be 0)
+ * @value: The value bytes (will be duplicated)
+ * @vlen: Length of @value
  *
- * Return: 1 if updated, 0 if not found, -1 on failure
+ * Description: Keys and values may hold any bytes, NUL included. Both
+ * are stored followed by a NUL byte, so string values read back through
+ * hash_table_get() are still NUL-terminated.
+ * Return: 1 if it succeeded, 0 otherwise
  */
-static int update_if_exists(hash_node_t *head, const char *key,
-			    const char *value)
+int hash_table_set_bin(hash_table_t *ht, const void *key, size_t klen,
+		       const void *value, size_t vlen)
 {
-	char *vdup;
+	unsigned long int hash;
 
-	while (head != NULL)
-	{
-		if (strcmp(head->key, key) == 0)
-		{
-			vdup = strdup(value);
-			if (vdup == NULL)
-				return (-1);
-			free(head->value);
-			head->value = vdup;
-			return (1);
-		}
-		head = head->next;
-	}
-	return (0);
+	if (ht == NULL || key == NULL || klen == 0 || value == NULL)
+		return (0);
+
+	hash = hash_table_hash(ht, key, klen);
+	return (hash_table_set_hashed(ht, key, klen, hash, value, vlen));
 }
 
 /**
- * hash_table_set - Adds or updates an element in a hash table
+ * hash_table_set_hashed - Adds or updates an element whose key is hashed
  * @ht: Pointer to the hash table
  * @key: The key (cannot be an empty string)
+ * @len: Length of @key
+ * @hash: The hash of @key
  * @value: The value associated with the key (will be duplicated)
+ * @vlen: Length of @value
  *
  * Return: 1 if it succeeded, 0 otherwise
  */
-int hash_table_set(hash_table_t *ht, const char *key, const char *value)
+int hash_table_set_hashed(hash_table_t *ht, const char *key, size_t len,
+			  unsigned long int hash, const char *value,
+			  size_t vlen)
 {
-	unsigned long int index;
+	hash_node_t **bucket;
 	hash_node_t *new_node;
 	int upd;
 
-	if (ht == NULL || key == NULL || *key == '\0' || value == NULL)
-		return (0);
-
-	index = key_index((const unsigned char *)key, ht->size);
+	hash_table_rehash_step(ht, HT_REHASH_STEP);
+	bucket = hash_table_bucket(ht, hash);
 
 	/* try update in-place if key exists */
-	upd = update_if_exists(ht->array[index], key, value);
+	upd = update_if_exists(ht, key, len, hash, value, vlen);
 	if (upd == 1)
+	{
+		HT_COUNT(ht, updates);
 		return (1);
+	}
 	if (upd == -1)
 		return (0);
 
 	/* insert new node at head (chaining) */
-	new_node = node_create(key, value);
+	new_node = hash_node_create(ht, key, len, hash, value, vlen);
 	if (new_node == NULL)
 		return (0);
 
-	new_node->next = ht->array[index];
-	ht->array[index] = new_node;
+	if (*bucket != NULL)
+		HT_COUNT(ht, collisions);
+	new_node->next = *bucket;
+	*bucket = new_node;
+	ht->count++;
+	HT_COUNT(ht, inserts);
+	hash_bloom_add(ht, hash);
 
+	/* a failed grow leaves a valid, only more loaded, table */
+	hash_table_grow(ht);
 	return (1);
 }
 
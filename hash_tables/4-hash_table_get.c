@@ -1,5 +1,64 @@
 #include "hash_tables.h"
 
+/**
+ * hash_chain_find - Finds a key in a bucket list
+ * @ht: Pointer to the hash table holding the list
+ * @node: Head of the bucket list
+ * @key: The key you are looking for
+ * @len: Length of @key
+ * @hash: The hash of @key
+ *
+ * Description: Nodes are rejected on their cached hash and key length
+ * first, so keys are only compared on a likely match; a key given by
+ * the pool of the table matches its node by address.
+ * Return: The node holding @key, or NULL if it isn't in the list
+ */
+hash_node_t *hash_chain_find(const hash_table_t *ht, hash_node_t *node,
+			     const char *key, size_t len,
+			     unsigned long int hash)
+{
+	const char *k;
+
+	while (node != NULL)
+	{
+		if (node->hash == hash && node->key_len == len)
+		{
+			k = hash_node_key(ht, node);
+			if (k == key || memcmp(k, key, len) == 0)
+				return (node);
+		}
+		node = node->next;
+	}
+	return (NULL);
+}
+
+/**
+ * hash_table_find - Finds the node holding a key
+ * @ht: Pointer to the hash table
+ * @key: The key you are looking for
+ * @len: Length of @key
+ * @hash: The hash of @key
+ *
+ * Description: A key the Bloom filter rules out is not searched for.
+ * Interned keys are searched like the others, without going through
+ * their pool, which would hash the key a second time.
+ * Return: The node holding @key, or NULL if it isn't in the table
+ */
+hash_node_t *hash_table_find(const hash_table_t *ht, const char *key,
+			     size_t len, unsigned long int hash)
+{
+	hash_node_t *node;
+
+	if (ht->bloom != NULL && !hash_bloom_test(ht, hash))
+		return (NULL);
+
+	node = hash_chain_find(ht, *hash_table_bucket(ht, hash), key, len,
+			       hash);
+	if (ht->bloom != NULL && node == NULL)
+		ht->bloom->false_positives++;
+	return (node);
+}
+
 /**
  * hash_table_get - Retrieves a value associated with a key
  * @ht: Pointer to the hash table
@@ -10,21 +69,39 @@
  */
 char *hash_table_get(const hash_table_t *ht, const char *key)
 {
-	unsigned long int index;
+	if (key == NULL)
+		return (NULL);
+	return (hash_table_get_bin(ht, key, strlen(key), NULL));
+}
+
+/**
+ * hash_table_get_bin - Retrieves a value associated with a binary key
+ * @ht: Pointer to the hash table
+ * @key: The key bytes
+ * @klen: Length of @key
+ * @vlen: If not NULL, receives the length of the value
+ *
+ * Return: The value associated with the key (followed by a NUL byte),
+ *         or NULL if the key couldn't be found
+ */
+void *hash_table_get_bin(const hash_table_t *ht, const void *key,
+			 size_t klen, size_t *vlen)
+{
+	unsigned long int hash;
 	hash_node_t *node;
 
-	if (ht == NULL || key == NULL || *key == '\0')
+	if (ht == NULL || key == NULL || klen == 0)
 		return (NULL);
 
-	index = key_index((const unsigned char *)key, ht->size);
-	node = ht->array[index];
-
-	while (node != NULL)
+	hash = hash_table_hash(ht, key, klen);
+	node = hash_table_find(ht, key, klen, hash);
+	if (node == NULL)
 	{
-		if (strcmp(node->key, key) == 0)
-			return (node->value);
-		node = node->next;
+		HT_COUNT(ht, get_misses);
+		return (NULL);
 	}
-
-	return (NULL);
+	HT_COUNT(ht, get_hits);
+	if (vlen != NULL)
+		*vlen = node->value_len;
+	return (hash_node_value(ht, node));
 }
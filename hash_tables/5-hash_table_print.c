@@ -1,35 +1,55 @@
 #include "hash_tables.h"
 
 /**
- * hash_table_print - Prints a hash table
+ * print_buckets - Prints every node of an array of bucket lists
  * @ht: Pointer to the hash table
+ * @array: Array of bucket lists (may be NULL)
+ * @size: The size of @array
+ * @first: Nonzero if nothing has been printed yet
  *
- * Description: Prints the key/value pairs in the order
- *              they appear in the array of the hash table.
- *              Format: {'key': 'value', 'key2': 'value2', ...}
- *              If ht is NULL, nothing is printed.
+ * Return: Zero if something has been printed so far, @first otherwise
  */
-void hash_table_print(const hash_table_t *ht)
+static int print_buckets(const hash_table_t *ht, hash_node_t **array,
+			 unsigned long int size, int first)
 {
 	unsigned long int i;
 	hash_node_t *node;
-	int first = 1;
-
-	if (ht == NULL)
-		return;
 
-	printf("{");
-	for (i = 0; i < ht->size; i++)
+	for (i = 0; array != NULL && i < size; i++)
 	{
-		node = ht->array[i];
+		node = array[i];
 		while (node != NULL)
 		{
 			if (!first)
 				printf(", ");
-			printf("'%s': '%s'", node->key, node->value);
+			printf("'%s': '%s'", hash_node_key(ht, node),
+			       hash_node_value(ht, node));
 			first = 0;
 			node = node->next;
 		}
 	}
+	return (first);
+}
+
+/**
+ * hash_table_print - Prints a hash table
+ * @ht: Pointer to the hash table
+ *
+ * Description: Prints the key/value pairs in the order
+ *              they appear in the array of the hash table.
+ *              Format: {'key': 'value', 'key2': 'value2', ...}
+ *              Buckets not yet migrated by a pending rehash come last.
+ *              If ht is NULL, nothing is printed.
+ */
+void hash_table_print(const hash_table_t *ht)
+{
+	int first;
+
+	if (ht == NULL)
+		return;
+
+	printf("{");
+	first = print_buckets(ht, ht->array, ht->size, 1);
+	print_buckets(ht, ht->old_array, ht->old_size, first);
 	printf("}\n");
 }
@@ -1,33 +1,54 @@
 #include "hash_tables.h"
 
 /**
- * hash_table_delete - Deletes a hash table
+ * free_buckets - Frees every node of an array of bucket lists
  * @ht: Pointer to the hash table
+ * @array: Array of bucket lists (may be NULL)
+ * @size: The size of @array
  *
- * Description: Frees all memory used by the hash table,
- * including all nodes, keys, and values.
+ * Description: Nodes of an arena-backed table are left to the arena,
+ * only their interned keys, if any, are given back to the pool.
  */
-void hash_table_delete(hash_table_t *ht)
+static void free_buckets(const hash_table_t *ht, hash_node_t **array,
+			 unsigned long int size)
 {
 	hash_node_t *node, *tmp;
 	unsigned long int i;
 
-	if (ht == NULL)
-		return;
+	if (ht->arena != NULL && ht->pool == NULL)
+		size = 0;
 
-	for (i = 0; i < ht->size; i++)
+	for (i = 0; array != NULL && i < size; i++)
 	{
-		node = ht->array[i];
+		node = array[i];
 		while (node != NULL)
 		{
 			tmp = node->next;
-			free(node->key);
-			free(node->value);
-			free(node);
+			hash_node_free(ht, node);
 			node = tmp;
 		}
 	}
+	free(array);
+}
+
+/**
+ * hash_table_delete - Deletes a hash table
+ * @ht: Pointer to the hash table
+ *
+ * Description: Frees all memory used by the hash table,
+ * including all nodes, keys, and values. An arena-backed table
+ * frees them slab by slab instead of node by node.
+ */
+void hash_table_delete(hash_table_t *ht)
+{
+	if (ht == NULL)
+		return;
 
-	free(ht->array);
+	hash_table_flush_removed(ht);
+	free_buckets(ht, ht->array, ht->size);
+	free_buckets(ht, ht->old_array, ht->old_size);
+	hash_arena_destroy(ht->arena);
+	free(ht->counters);
+	hash_table_bloom_enable(ht, 0);
 	free(ht);
 }
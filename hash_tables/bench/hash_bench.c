@@ -0,0 +1,855 @@
+/*
+ * hash_bench - Benchmarks the hash tables of hash_tables/
+ *
+ * Build (from hash_tables/bench):
+ *   gcc -O2 -Wall -Werror -Wextra -pedantic -std=gnu89 -I.. \
+ *       ../[0-9]*.c hash_bench.c -o hash_bench -lpthread -lm
+ *
+ * Usage: ./hash_bench [-t chained|oa|chash] [-d uniform|zipf|adversarial]
+ *                     [-h djb2|xx] [-n keys] [-o ops] [-m I/L/M/D]
+ *                     [-j threads] [-s]
+ *
+ * The table is loaded with -n keys, then each of the -j threads runs -o
+ * operations drawn from the -m mix: percentages of inserts (new keys),
+ * lookups (present keys, picked from the -d distribution), misses and
+ * deletes (of keys the thread inserted). Reported: ops/sec over all
+ * threads, p50/p99 latency of one operation and bytes per entry.
+ * Threads other than 1 need -t chash.
+ *
+ * -s runs the suite instead: OA vs chained tables from 1M keys up to -n
+ * keys, hash function throughput per key length, chash scaling from 1
+ * to -j threads and snapshot startup time.
+ *
+ * Adversarial keys all collide under djb2 (every key is a sequence of
+ * "ab"/"bA" pairs); keep -n small with -h djb2, or see -h xx hold up.
+ */
+#include "hash_tables.h"
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#define OP_INSERT 0
+#define OP_LOOKUP 1
+#define OP_MISS 2
+#define OP_DELETE 3
+
+#define DIST_UNIFORM 0
+#define DIST_ZIPF 1
+#define DIST_ADVERSARIAL 2
+
+#define ZIPF_THETA 0.99
+#define MISS_BASE (1UL << 31)
+#define KEY_MAX 80
+
+/**
+ * struct bench_table_s - Table under test, behind a common interface
+ * @name: Name of the table type
+ * @t: The table
+ * @set: Adds or updates a key
+ * @get: Looks a key up, returns nonzero if found
+ * @remove: Removes a key
+ * @memory: Gives the bytes used by the table and its number of entries
+ * @destroy: Deletes the table
+ */
+typedef struct bench_table_s
+{
+	const char *name;
+	void *t;
+	int (*set)(void *t, const char *key, const char *value);
+	int (*get)(void *t, const char *key);
+	int (*remove)(void *t, const char *key);
+	size_t (*memory)(void *t, unsigned long int *count);
+	void (*destroy)(void *t);
+} bench_table_t;
+
+/**
+ * struct bench_conf_s - Parameters of a run
+ * @table: Table type ("chained", "oa" or "chash")
+ * @dist: DIST_UNIFORM, DIST_ZIPF or DIST_ADVERSARIAL
+ * @hf: Hash function of chained tables
+ * @keys: Number of keys loaded before the measured operations
+ * @ops: Number of operations per thread
+ * @mix: Percentage of each OP_ type
+ * @threads: Number of threads
+ * @zetan: Zeta constant of the Zipf distribution over @keys
+ * @eta: Eta constant of the Zipf distribution over @keys
+ */
+typedef struct bench_conf_s
+{
+	const char *table;
+	int dist;
+	const hash_func_t *hf;
+	unsigned long int keys;
+	unsigned long int ops;
+	unsigned int mix[4];
+	unsigned long int threads;
+	double zetan;
+	double eta;
+} bench_conf_t;
+
+/**
+ * struct bench_thread_s - State of one benchmark thread
+ * @conf: Parameters of the run
+ * @bt: Table under test
+ * @start: Barrier the threads start the clock on
+ * @id: Index of the thread
+ * @rng: State of the xorshift generator of the thread
+ * @lat: Latency of each operation, in nanoseconds
+ */
+typedef struct bench_thread_s
+{
+	const bench_conf_t *conf;
+	bench_table_t *bt;
+	pthread_barrier_t *start;
+	unsigned long int id;
+	unsigned long int rng;
+	unsigned int *lat;
+} bench_thread_t;
+
+/**
+ * now_ns - Reads the monotonic clock
+ *
+ * Return: Time in nanoseconds
+ */
+static unsigned long int now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000000000UL + ts.tv_nsec);
+}
+
+/**
+ * rng_next - Draws a random number (xorshift64*)
+ * @s: State of the generator (nonzero)
+ *
+ * Return: The number
+ */
+static unsigned long int rng_next(unsigned long int *s)
+{
+	*s ^= *s >> 12;
+	*s ^= *s << 25;
+	*s ^= *s >> 27;
+	return (*s * 0x2545f4914f6cdd1dUL);
+}
+
+/**
+ * make_key - Writes the key of a key id
+ * @buf: Buffer of at least KEY_MAX bytes
+ * @id: Key id
+ * @dist: Distribution of the run
+ *
+ * Description: Adversarial keys spell the low 32 bits of the id with
+ * "ab" for 0 and "bA" for 1, and 'a' * 33 + 'b' == 'b' * 33 + 'A', so
+ * all of them have the same djb2 hash.
+ */
+static void make_key(char *buf, unsigned long int id, int dist)
+{
+	static const char hex[] = "0123456789abcdef";
+	int i;
+
+	if (dist == DIST_ADVERSARIAL)
+	{
+		for (i = 0; i < 32; i++)
+		{
+			buf[2 * i] = (id >> i) & 1 ? 'b' : 'a';
+			buf[2 * i + 1] = (id >> i) & 1 ? 'A' : 'b';
+		}
+		buf[64] = '\0';
+		return;
+	}
+	memcpy(buf, "key:", 4);
+	for (i = 0; i < 16; i++)
+		buf[4 + i] = hex[(id >> (60 - 4 * i)) & 0xf];
+	buf[20] = '\0';
+}
+
+/**
+ * zipf_init - Computes the constants of the Zipf distribution
+ * @conf: Parameters of the run (@conf->keys is used)
+ */
+static void zipf_init(bench_conf_t *conf)
+{
+	unsigned long int i;
+	double zeta2 = 1 + pow(0.5, ZIPF_THETA);
+
+	conf->zetan = 0;
+	for (i = 1; i <= conf->keys; i++)
+		conf->zetan += 1 / pow((double)i, ZIPF_THETA);
+	conf->eta = (1 - pow(2.0 / conf->keys, 1 - ZIPF_THETA)) /
+		(1 - zeta2 / conf->zetan);
+}
+
+/**
+ * pick_key - Draws the id of a loaded key
+ * @conf: Parameters of the run
+ * @rng: State of the generator of the thread
+ *
+ * Description: Zipf ids follow Gray et al., "Quickly generating
+ * billion-record synthetic databases": id 0 is the most popular.
+ * Return: An id in [0, @conf->keys)
+ */
+static unsigned long int pick_key(const bench_conf_t *conf,
+				  unsigned long int *rng)
+{
+	double u, uz;
+	unsigned long int id;
+
+	if (conf->dist != DIST_ZIPF)
+		return (rng_next(rng) % conf->keys);
+	u = (rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+	uz = u * conf->zetan;
+	if (uz < 1)
+		return (0);
+	if (uz < 1 + pow(0.5, ZIPF_THETA))
+		return (1);
+	id = conf->keys * pow(conf->eta * u - conf->eta + 1,
+			      1 / (1 - ZIPF_THETA));
+	return (id < conf->keys ? id : conf->keys - 1);
+}
+
+/**
+ * pick_op - Draws the type of the next operation
+ * @th: The thread
+ * @inserted: Number of keys the thread inserted so far
+ * @deleted: Number of those it deleted so far
+ *
+ * Description: A delete with nothing left to delete becomes an insert.
+ * Return: One of the OP_ types
+ */
+static int pick_op(bench_thread_t *th, unsigned long int inserted,
+		   unsigned long int deleted)
+{
+	unsigned int r = rng_next(&th->rng) % 100, op = 0;
+
+	while (op < OP_DELETE && r >= th->conf->mix[op])
+		r -= th->conf->mix[op++];
+	if (op == OP_DELETE && deleted == inserted)
+		return (OP_INSERT);
+	return (op);
+}
+
+/**
+ * bench_worker - Runs the operations of one thread
+ * @arg: The bench_thread_t of the thread
+ *
+ * Description: Inserted ids are private to the thread, so deletes only
+ * ever remove keys of the thread, oldest first.
+ * Return: NULL
+ */
+static void *bench_worker(void *arg)
+{
+	bench_thread_t *th = arg;
+	const bench_conf_t *conf = th->conf;
+	unsigned long int i, id, t0, ins = 0, del = 0;
+	unsigned long int base = conf->keys + th->id * conf->ops;
+	char key[KEY_MAX];
+	int op;
+
+	pthread_barrier_wait(th->start);
+	for (i = 0; i < conf->ops; i++)
+	{
+		op = pick_op(th, ins, del);
+		if (op == OP_INSERT)
+			id = base + ins++;
+		else if (op == OP_DELETE)
+			id = base + del++;
+		else if (op == OP_MISS)
+			id = MISS_BASE + rng_next(&th->rng) % MISS_BASE;
+		else
+			id = pick_key(conf, &th->rng);
+		make_key(key, id, conf->dist);
+		t0 = now_ns();
+		if (op == OP_INSERT)
+			th->bt->set(th->bt->t, key, key);
+		else if (op == OP_DELETE)
+			th->bt->remove(th->bt->t, key);
+		else
+			th->bt->get(th->bt->t, key);
+		th->lat[i] = now_ns() - t0;
+	}
+	return (NULL);
+}
+
+/* ---- table adapters ---- */
+
+/**
+ * ch_set - hash_table_set() adapter
+ * @t: Table
+ * @k: Key
+ * @v: Value
+ *
+ * Return: As hash_table_set()
+ */
+static int ch_set(void *t, const char *k, const char *v)
+{
+	return (hash_table_set(t, k, v));
+}
+
+/**
+ * ch_get - hash_table_get() adapter
+ * @t: Table
+ * @k: Key
+ *
+ * Return: Nonzero if found
+ */
+static int ch_get(void *t, const char *k)
+{
+	return (hash_table_get(t, k) != NULL);
+}
+
+/**
+ * ch_remove - hash_table_remove() adapter
+ * @t: Table
+ * @k: Key
+ *
+ * Return: As hash_table_remove()
+ */
+static int ch_remove(void *t, const char *k)
+{
+	return (hash_table_remove(t, k));
+}
+
+/**
+ * ch_memory - Bytes used by a chained table
+ * @t: Table
+ * @count: Receives the number of entries
+ *
+ * Return: Bytes, as reported by hash_table_stats()
+ */
+static size_t ch_memory(void *t, unsigned long int *count)
+{
+	hash_stats_t st;
+
+	hash_table_stats(t, &st);
+	*count = st.count;
+	return (st.memory);
+}
+
+/**
+ * ch_destroy - hash_table_delete() adapter
+ * @t: Table
+ */
+static void ch_destroy(void *t)
+{
+	hash_table_delete(t);
+}
+
+/**
+ * oa_set - oa_hash_table_set() adapter
+ * @t: Table
+ * @k: Key
+ * @v: Value
+ *
+ * Return: As oa_hash_table_set()
+ */
+static int oa_set(void *t, const char *k, const char *v)
+{
+	return (oa_hash_table_set(t, k, v));
+}
+
+/**
+ * oa_get - oa_hash_table_get() adapter
+ * @t: Table
+ * @k: Key
+ *
+ * Return: Nonzero if found
+ */
+static int oa_get(void *t, const char *k)
+{
+	return (oa_hash_table_get(t, k) != NULL);
+}
+
+/**
+ * oa_remove - oa_hash_table_remove() adapter
+ * @t: Table
+ * @k: Key
+ *
+ * Return: As oa_hash_table_remove()
+ */
+static int oa_remove(void *t, const char *k)
+{
+	return (oa_hash_table_remove(t, k));
+}
+
+/**
+ * oa_memory - Bytes used by an open-addressing table
+ * @t: Table
+ * @count: Receives the number of entries
+ *
+ * Return: Bytes of the slots, control bytes, keys and values
+ */
+static size_t oa_memory(void *t, unsigned long int *count)
+{
+	oa_hash_table_t *ht = t;
+	size_t n = sizeof(*ht) + ht->size * (1 + sizeof(oa_slot_t));
+	unsigned long int i;
+
+	for (i = 0; i < ht->size; i++)
+		if (ht->ctrl[i] != 0)
+			n += strlen(ht->slots[i].key) +
+				strlen(ht->slots[i].value) + 2;
+	*count = ht->count;
+	return (n);
+}
+
+/**
+ * oa_destroy - oa_hash_table_delete() adapter
+ * @t: Table
+ */
+static void oa_destroy(void *t)
+{
+	oa_hash_table_delete(t);
+}
+
+/**
+ * cht_set - chash_table_set() adapter
+ * @t: Table
+ * @k: Key
+ * @v: Value
+ *
+ * Return: As chash_table_set()
+ */
+static int cht_set(void *t, const char *k, const char *v)
+{
+	return (chash_table_set(t, k, v));
+}
+
+/**
+ * cht_get - chash_table_get() adapter
+ * @t: Table
+ * @k: Key
+ *
+ * Return: Nonzero if found
+ */
+static int cht_get(void *t, const char *k)
+{
+	char *v = chash_table_get(t, k);
+
+	free(v);
+	return (v != NULL);
+}
+
+/**
+ * cht_remove - chash_table_remove() adapter
+ * @t: Table
+ * @k: Key
+ *
+ * Return: As chash_table_remove()
+ */
+static int cht_remove(void *t, const char *k)
+{
+	return (chash_table_remove(t, k));
+}
+
+/**
+ * cht_memory - Bytes used by a concurrent table
+ * @t: Table
+ * @count: Receives the number of entries
+ *
+ * Return: Bytes of the underlying table and of the lock stripes
+ */
+static size_t cht_memory(void *t, unsigned long int *count)
+{
+	chash_table_t *cht = t;
+
+	return (ch_memory(cht->ht, count) +
+		cht->nlocks * sizeof(cht_lock_t));
+}
+
+/**
+ * cht_destroy - chash_table_delete() adapter
+ * @t: Table
+ */
+static void cht_destroy(void *t)
+{
+	chash_table_delete(t);
+}
+
+static const bench_table_t bench_tables[] = {
+	{"chained", NULL, ch_set, ch_get, ch_remove, ch_memory, ch_destroy},
+	{"oa", NULL, oa_set, oa_get, oa_remove, oa_memory, oa_destroy},
+	{"chash", NULL, cht_set, cht_get, cht_remove, cht_memory, cht_destroy}
+};
+
+/**
+ * table_open - Creates the table of a run
+ * @bt: Receives the table
+ * @conf: Parameters of the run
+ *
+ * Description: -h only applies to chained tables.
+ * Return: 1 on success, 0 on failure
+ */
+static int table_open(bench_table_t *bt, const bench_conf_t *conf)
+{
+	hash_opts_t opts;
+	int i;
+
+	for (i = 0; i < 3; i++)
+		if (strcmp(conf->table, bench_tables[i].name) == 0)
+			break;
+	if (i == 3)
+		return (0);
+	*bt = bench_tables[i];
+	memset(&opts, 0, sizeof(opts));
+	opts.hf = conf->hf;
+	if (conf->hf == &hash_func_xx)
+		opts.seed = hash_random_seed();
+	if (i == 0)
+		bt->t = hash_table_create_opts(1024, &opts);
+	else if (i == 1)
+		bt->t = oa_hash_table_create(1024);
+	else
+		bt->t = chash_table_create(1024, 0);
+	return (bt->t != NULL);
+}
+
+/**
+ * table_load - Inserts the keys a run starts with
+ * @bt: Table
+ * @conf: Parameters of the run
+ *
+ * Return: Seconds it took
+ */
+static double table_load(bench_table_t *bt, const bench_conf_t *conf)
+{
+	unsigned long int i, t0 = now_ns();
+	char key[KEY_MAX];
+
+	for (i = 0; i < conf->keys; i++)
+	{
+		make_key(key, i, conf->dist);
+		bt->set(bt->t, key, key);
+	}
+	return ((now_ns() - t0) / 1e9);
+}
+
+/**
+ * cmp_uint - qsort() comparison of unsigned ints
+ * @a: First one
+ * @b: Second one
+ *
+ * Return: Negative, zero or positive
+ */
+static int cmp_uint(const void *a, const void *b)
+{
+	unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+
+	return ((x > y) - (x < y));
+}
+
+/**
+ * print_result - Prints the throughput, latencies and memory of a run
+ * @bt: The table
+ * @conf: Parameters of the run
+ * @lat: Latency of each of the @n operations, in ns (sorted here)
+ * @n: Number of operations
+ * @secs: Duration of the run
+ */
+static void print_result(bench_table_t *bt, const bench_conf_t *conf,
+			 unsigned int *lat, unsigned long int n, double secs)
+{
+	unsigned long int count;
+	size_t mem = bt->memory(bt->t, &count);
+
+	qsort(lat, n, sizeof(*lat), cmp_uint);
+	printf("%-7s %-11s keys=%-9lu threads=%-3lu mix=%u/%u/%u/%u: ",
+	       bt->name, conf->dist == DIST_UNIFORM ? "uniform" :
+	       conf->dist == DIST_ZIPF ? "zipf" : "adversarial", conf->keys,
+	       conf->threads, conf->mix[0], conf->mix[1], conf->mix[2],
+	       conf->mix[3]);
+	printf("%8.2f Mops/s  p50 %5u ns  p99 %6u ns  %6.1f B/entry\n",
+	       n / secs / 1e6, n ? lat[n / 2] : 0, n ? lat[n * 99 / 100] : 0,
+	       (double)mem / (count ? count : 1));
+}
+
+/**
+ * run_threads - Runs the measured operations and prints the results
+ * @bt: Loaded table
+ * @conf: Parameters of the run
+ *
+ * Return: 1 on success, 0 on failure
+ */
+static int run_threads(bench_table_t *bt, const bench_conf_t *conf)
+{
+	unsigned long int i, n = conf->threads * conf->ops, t0;
+	bench_thread_t *th = calloc(conf->threads, sizeof(*th));
+	pthread_t *tid = calloc(conf->threads, sizeof(*tid));
+	unsigned int *lat = malloc(sizeof(*lat) * (n ? n : 1));
+	pthread_barrier_t start;
+	double secs;
+
+	if (th == NULL || tid == NULL || lat == NULL)
+	{
+		free(th);
+		free(tid);
+		free(lat);
+		return (0);
+	}
+	pthread_barrier_init(&start, NULL, conf->threads + 1);
+	for (i = 0; i < conf->threads; i++)
+	{
+		th[i].conf = conf;
+		th[i].bt = bt;
+		th[i].start = &start;
+		th[i].id = i;
+		th[i].rng = 0x9e3779b97f4a7c15UL * (i + 1);
+		th[i].lat = lat + i * conf->ops;
+		pthread_create(&tid[i], NULL, bench_worker, &th[i]);
+	}
+	pthread_barrier_wait(&start);
+	t0 = now_ns();
+	for (i = 0; i < conf->threads; i++)
+		pthread_join(tid[i], NULL);
+	secs = (now_ns() - t0) / 1e9;
+	pthread_barrier_destroy(&start);
+	print_result(bt, conf, lat, n, secs);
+	free(th);
+	free(tid);
+	free(lat);
+	return (1);
+}
+
+/**
+ * run_mix - Loads a table and runs the measured operations on it
+ * @conf: Parameters of the run
+ *
+ * Return: 1 on success, 0 on failure
+ */
+static int run_mix(bench_conf_t *conf)
+{
+	bench_table_t bt;
+	int ok;
+
+	if (conf->threads > 1 && strcmp(conf->table, "chash") != 0)
+	{
+		fprintf(stderr, "hash_bench: -j needs -t chash\n");
+		return (0);
+	}
+	if (conf->dist == DIST_ZIPF)
+		zipf_init(conf);
+	if (!table_open(&bt, conf))
+		return (0);
+	table_load(&bt, conf);
+	ok = run_threads(&bt, conf);
+	bt.destroy(bt.t);
+	return (ok);
+}
+
+/* ---- suite ---- */
+
+/**
+ * suite_oa_vs_chained - Compares OA and chained tables at several sizes
+ * @conf: Parameters of the suite (@conf->keys is the largest size)
+ */
+static void suite_oa_vs_chained(const bench_conf_t *conf)
+{
+	static const unsigned long int sizes[] = {1000000, 5000000,
+						  10000000, 50000000};
+	static const char *const tables[] = {"chained", "oa"};
+	bench_conf_t c = *conf;
+	bench_table_t bt;
+	unsigned long int s, i, t0, count;
+	char key[KEY_MAX];
+	double load;
+	int k;
+
+	printf("== OA vs chained: load, then one lookup per key ==\n");
+	for (s = 0; s < 4 && (s == 0 || sizes[s] <= conf->keys); s++)
+		for (k = 0; k < 2; k++)
+		{
+			c.keys = sizes[s];
+			c.table = tables[k];
+			c.dist = DIST_UNIFORM;
+			if (!table_open(&bt, &c))
+				return;
+			load = table_load(&bt, &c);
+			t0 = now_ns();
+			for (i = 0; i < c.keys; i++)
+			{
+				make_key(key, (i * 0x9e3779b1UL) % c.keys,
+					 DIST_UNIFORM);
+				bt.get(bt.t, key);
+			}
+			printf("%-7s keys=%-9lu insert %6.2f Mops/s  lookup "
+			       "%6.2f Mops/s  %6.1f B/entry\n", c.table, c.keys,
+			       c.keys / load / 1e6,
+			       c.keys / ((now_ns() - t0) / 1e9) / 1e6,
+			       (double)bt.memory(bt.t, &count) / c.keys);
+			bt.destroy(bt.t);
+		}
+}
+
+/**
+ * suite_hash_funcs - Measures hash function throughput per key length
+ */
+static void suite_hash_funcs(void)
+{
+	static const size_t lens[] = {4, 8, 16, 32, 64, 256, 1024, 4096};
+	static const hash_func_t *const hf[] = {&hash_func_djb2,
+						 &hash_func_xx};
+	unsigned char buf[4096 + 64];
+	unsigned long int i, n, t0, sink = 0, rng = 1;
+	size_t l;
+	double secs;
+	int f;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = rng_next(&rng);
+	printf("== hash functions: 256 MiB of keys per length ==\n");
+	for (f = 0; f < 2; f++)
+		for (l = 0; l < sizeof(lens) / sizeof(lens[0]); l++)
+		{
+			n = (256UL << 20) / lens[l];
+			t0 = now_ns();
+			for (i = 0; i < n; i++)
+				sink += hf[f]->hash(buf + (i & 63), lens[l],
+						    sink);
+			secs = (now_ns() - t0) / 1e9;
+			printf("%-5s len=%-5lu %7.2f GB/s  %7.2f ns/hash\n",
+			       hf[f]->name, (unsigned long int)lens[l],
+			       n * lens[l] / secs / 1e9, secs * 1e9 / n);
+		}
+	if (sink == 42)
+		printf("\n");
+}
+
+/**
+ * suite_snapshot - Compares snapshot startup with rebuilding the table
+ * @conf: Parameters of the suite (@conf->keys keys are used)
+ */
+static void suite_snapshot(const bench_conf_t *conf)
+{
+	char path[] = "/tmp/hash_benchXXXXXX", key[KEY_MAX];
+	hash_table_t *ht = hash_table_create(1024);
+	hash_snapshot_t *snap;
+	unsigned long int i, t0;
+	double build;
+	int fd = mkstemp(path);
+
+	if (ht == NULL || fd == -1)
+	{
+		hash_table_delete(ht);
+		return;
+	}
+	close(fd);
+	t0 = now_ns();
+	for (i = 0; i < conf->keys; i++)
+	{
+		make_key(key, i, DIST_UNIFORM);
+		hash_table_set(ht, key, key);
+	}
+	build = (now_ns() - t0) / 1e9;
+	hash_table_save(ht, path);
+	hash_table_delete(ht);
+	t0 = now_ns();
+	snap = hash_table_load_mmap(path);
+	make_key(key, conf->keys / 2, DIST_UNIFORM);
+	if (snap != NULL && hash_snapshot_get(snap, key) != NULL)
+		printf("== snapshot, %lu keys ==\nrebuild %.3f s  "
+		       "load_mmap + first lookup %.6f s\n", conf->keys, build,
+		       (now_ns() - t0) / 1e9);
+	hash_snapshot_close(snap);
+	unlink(path);
+}
+
+/**
+ * run_suite - Runs the whole benchmark suite
+ * @conf: Parameters of the suite
+ */
+static void run_suite(bench_conf_t *conf)
+{
+	unsigned long int maxj = conf->threads, j;
+	static const unsigned int mix[4] = {10, 80, 5, 5};
+
+	suite_oa_vs_chained(conf);
+	suite_hash_funcs();
+	printf("== chash scaling, uniform 10/80/5/5 ==\n");
+	conf->table = "chash";
+	conf->dist = DIST_UNIFORM;
+	memcpy(conf->mix, mix, sizeof(mix));
+	for (j = 1; j <= maxj; j *= 2)
+	{
+		conf->threads = j;
+		run_mix(conf);
+	}
+	suite_snapshot(conf);
+}
+
+/**
+ * parse_opt - Applies one command line option
+ * @conf: Parameters being built
+ * @opt: Option letter
+ * @arg: Option argument
+ *
+ * Return: 1 if valid, 0 otherwise
+ */
+static int parse_opt(bench_conf_t *conf, int opt, const char *arg)
+{
+	if (opt == 't')
+		conf->table = arg;
+	else if (opt == 'd')
+		conf->dist = strcmp(arg, "zipf") == 0 ? DIST_ZIPF :
+			strcmp(arg, "adversarial") == 0 ? DIST_ADVERSARIAL :
+			strcmp(arg, "uniform") == 0 ? DIST_UNIFORM : -1;
+	else if (opt == 'h')
+		conf->hf = strcmp(arg, "xx") == 0 ? &hash_func_xx :
+			strcmp(arg, "djb2") == 0 ? &hash_func_djb2 : NULL;
+	else if (opt == 'n')
+		conf->keys = strtoul(arg, NULL, 10);
+	else if (opt == 'o')
+		conf->ops = strtoul(arg, NULL, 10);
+	else if (opt == 'j')
+		conf->threads = strtoul(arg, NULL, 10);
+	else if (opt == 'm')
+		return (sscanf(arg, "%u/%u/%u/%u", &conf->mix[0],
+			       &conf->mix[1], &conf->mix[2],
+			       &conf->mix[3]) == 4 &&
+			conf->mix[0] + conf->mix[1] + conf->mix[2] +
+			conf->mix[3] == 100);
+	else
+		return (0);
+	return (conf->dist != -1 && conf->hf != NULL && conf->keys > 0 &&
+		conf->threads > 0);
+}
+
+/**
+ * main - Entry point
+ * @argc: Number of arguments
+ * @argv: Arguments
+ *
+ * Return: 0 on success, 1 on failure
+ */
+int main(int argc, char **argv)
+{
+	static const unsigned int mix[4] = {10, 80, 5, 5};
+	bench_conf_t conf;
+	int opt, suite = 0;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.table = "chained";
+	conf.hf = &hash_func_djb2;
+	conf.keys = 1000000;
+	conf.ops = 1000000;
+	conf.threads = 1;
+	memcpy(conf.mix, mix, sizeof(mix));
+	while ((opt = getopt(argc, argv, "t:d:h:n:o:m:j:s")) != -1)
+	{
+		if (opt == 's')
+			suite = 1;
+		else if (!parse_opt(&conf, opt, optarg))
+		{
+			fprintf(stderr, "Usage: %s [-t chained|oa|chash] "
+				"[-d uniform|zipf|adversarial] [-h djb2|xx] "
+				"[-n keys] [-o ops] [-m I/L/M/D] [-j threads] "
+				"[-s]\n", argv[0]);
+			return (1);
+		}
+	}
+	if (suite)
+	{
+		run_suite(&conf);
+		return (0);
+	}
+	return (run_mix(&conf) ? 0 : 1);
+}
@@ -0,0 +1,304 @@
+#ifndef HASH_MAP_H
+#define HASH_MAP_H
+
+#include "hash_tables.h"
+
+/*
+ * Typed hash maps, generated by DEFINE_HASHMAP(name, key_type, val_type,
+ * hash, eq) for any key and value types (integers, pointers, structs).
+ *
+ * @hash(key) must return an unsigned long int and @eq(a, b) nonzero when
+ * two keys are equal; both may be macros, so they are expanded inline.
+ * The result of @hash is mixed with hash_mix(), so the identity is a fine
+ * hash for integer keys (see HM_HASH_INT).
+ *
+ * Maps share the probing of oa_hash_table_t, generated for both by
+ * HM_DEFINE_PROBE: one control byte per slot (0 for empty, else 1 +
+ * distance to the home slot) and Robin Hood probing with backward-shift
+ * removal. Keys and values are stored by value in the slots, so an entry
+ * costs no allocation of its own. The following are generated:
+ *
+ * name_t *name_create(unsigned long int size);
+ * void name_delete(name_t *m);
+ * int name_set(name_t *m, key_type key, val_type val);
+ * val_type *name_get(const name_t *m, key_type key);
+ * int name_remove(name_t *m, key_type key);
+ *
+ * name_get() returns a pointer into the slots, valid until the next
+ * name_set() or name_remove(). m->count holds the number of entries.
+ */
+
+#define HM_MIN_SIZE 8
+#define HM_MAX_DIST 255
+
+/* hash and eq for integer and pointer keys */
+#define HM_HASH_INT(k) ((unsigned long int)(k))
+#define HM_EQ_INT(a, b) ((a) == (b))
+
+/*
+ * HM_DEFINE_PROBE(name, map_t, slot_t, key_type, slot_hash, match)
+ * generates the Robin Hood probing of a map type with the members size,
+ * count, ctrl and slots (an array of slot_t). slot_hash(&slot) gives the
+ * hash of the key of a slot, and match(&slot, key, hash) tells whether a
+ * slot holds key. The following are generated:
+ *
+ * int name_init(map_t *m, unsigned long int size);
+ *	sets up at least size slots (a power of two), 0 on failure
+ * unsigned long int name_find(const map_t *m, key_type key,
+ *			       unsigned long int hash);
+ *	index of the slot holding key, or m->size
+ * int name_insert(map_t *m, slot_t *s);
+ *	adds a slot whose key is absent, 0 on failure
+ * void name_erase(map_t *m, unsigned long int idx);
+ *	removes the slot at idx (its key and value are not freed)
+ *
+ * A map grows once it is 80% full. A probe sequence too long for a
+ * control byte makes it grow only while it is at least half full; below
+ * that, it is made of keys sharing a hash, which growing wouldn't
+ * separate: the insertion is turned down with the map left as it was.
+ */
+#define HM_DEFINE_PROBE(name, map_t, slot_t, key_type, slot_hash, match) \
+static __inline__ int name##_alloc(map_t *m, unsigned long int size)	\
+{									\
+	unsigned char *ctrl = calloc(size, 1);				\
+	slot_t *slots = malloc(sizeof(slot_t) * size);			\
+									\
+	if (ctrl == NULL || slots == NULL)				\
+	{								\
+		free(ctrl);						\
+		free(slots);						\
+		return (0);						\
+	}								\
+	m->ctrl = ctrl;							\
+	m->slots = slots;						\
+	m->size = size;							\
+	return (1);							\
+}									\
+									\
+static __inline__ int name##_init(map_t *m, unsigned long int size)	\
+{									\
+	unsigned long int n = HM_MIN_SIZE;				\
+									\
+	while (n < size && (n << 1) != 0)				\
+		n <<= 1;						\
+	m->count = 0;							\
+	return (name##_alloc(m, n));					\
+}									\
+									\
+static __inline__ int name##_place(map_t *m, slot_t *in)		\
+{									\
+	unsigned long int mask = m->size - 1, idx;			\
+	unsigned int d = 1, c;						\
+	slot_t tmp;							\
+									\
+	idx = hash_mix(slot_hash(in)) & mask;				\
+	while (d < HM_MAX_DIST)						\
+	{								\
+		c = m->ctrl[idx];					\
+		if (c == 0)						\
+		{							\
+			m->ctrl[idx] = (unsigned char)d;		\
+			m->slots[idx] = *in;				\
+			return (1);					\
+		}							\
+		if (c < d)						\
+		{							\
+			tmp = m->slots[idx];				\
+			m->slots[idx] = *in;				\
+			*in = tmp;					\
+			m->ctrl[idx] = (unsigned char)d;		\
+			d = c;						\
+		}							\
+		idx = (idx + 1) & mask;					\
+		d++;							\
+	}								\
+	return (0);							\
+}									\
+									\
+static __inline__ int name##_fits(const map_t *m, unsigned long int h)	\
+{									\
+	unsigned long int mask = m->size - 1, idx;			\
+	unsigned int d = 1, c;						\
+									\
+	idx = hash_mix(h) & mask;					\
+	while (d < HM_MAX_DIST)						\
+	{								\
+		c = m->ctrl[idx];					\
+		if (c == 0)						\
+			return (1);					\
+		if (c < d)						\
+			d = c;						\
+		idx = (idx + 1) & mask;					\
+		d++;							\
+	}								\
+	return (0);							\
+}									\
+									\
+static __inline__ int name##_grow(map_t *m)				\
+{									\
+	map_t old = *m;							\
+	unsigned long int i;						\
+	slot_t s;							\
+									\
+	if ((m->size << 1) == 0 || !name##_alloc(m, m->size << 1))	\
+		return (0);						\
+	for (i = 0; i < old.size; i++)					\
+	{								\
+		s = old.slots[i];					\
+		if (old.ctrl[i] != 0 && !name##_place(m, &s))		\
+			break;						\
+	}								\
+	if (i == old.size)						\
+	{								\
+		free(old.ctrl);						\
+		free(old.slots);					\
+		return (1);						\
+	}								\
+	free(m->ctrl);							\
+	free(m->slots);							\
+	*m = old;							\
+	return (0);							\
+}									\
+									\
+static __inline__ unsigned long int name##_find(const map_t *m,	\
+						 key_type key,		\
+						 unsigned long int h)	\
+{									\
+	unsigned long int mask = m->size - 1, idx;			\
+	unsigned int d = 1;						\
+									\
+	idx = hash_mix(h) & mask;					\
+	while (d < HM_MAX_DIST && m->ctrl[idx] >= d)			\
+	{								\
+		if (m->ctrl[idx] == d && match(&m->slots[idx], key, h))	\
+			return (idx);					\
+		idx = (idx + 1) & mask;					\
+		d++;							\
+	}								\
+	return (m->size);						\
+}									\
+									\
+static __inline__ int name##_insert(map_t *m, slot_t *s)		\
+{									\
+	if ((m->count + 1) * 5 > m->size * 4 && !name##_grow(m))	\
+		return (0);						\
+	while (!name##_fits(m, slot_hash(s)))				\
+	{								\
+		if ((m->count + 1) * 2 < m->size || !name##_grow(m))	\
+			return (0);					\
+	}								\
+	name##_place(m, s);						\
+	m->count++;							\
+	return (1);							\
+}									\
+									\
+static __inline__ void name##_erase(map_t *m, unsigned long int idx)	\
+{									\
+	unsigned long int mask = m->size - 1, next;			\
+									\
+	next = (idx + 1) & mask;					\
+	while (m->ctrl[next] > 1)					\
+	{								\
+		m->slots[idx] = m->slots[next];				\
+		m->ctrl[idx] = m->ctrl[next] - 1;			\
+		idx = next;						\
+		next = (next + 1) & mask;				\
+	}								\
+	m->ctrl[idx] = 0;						\
+	m->count--;							\
+}
+
+#define DEFINE_HASHMAP(name, key_type, val_type, hash, eq)		\
+typedef struct name##_slot_s						\
+{									\
+	key_type key;							\
+	val_type val;							\
+} name##_slot_t;							\
+									\
+typedef struct name##_s							\
+{									\
+	unsigned char *ctrl;						\
+	name##_slot_t *slots;						\
+	unsigned long int size;						\
+	unsigned long int count;					\
+} name##_t;								\
+									\
+static __inline__ unsigned long int					\
+name##_slot_hash(const name##_slot_t *s)				\
+{									\
+	return (hash(s->key));						\
+}									\
+									\
+static __inline__ int name##_match(const name##_slot_t *s, key_type key, \
+				   unsigned long int h)			\
+{									\
+	(void)h;							\
+	return (eq(s->key, key));					\
+}									\
+									\
+HM_DEFINE_PROBE(name, name##_t, name##_slot_t, key_type,		\
+		name##_slot_hash, name##_match)				\
+									\
+static __inline__ name##_t *name##_create(unsigned long int size)	\
+{									\
+	name##_t *m = malloc(sizeof(name##_t));				\
+									\
+	if (m != NULL && !name##_init(m, size))				\
+	{								\
+		free(m);						\
+		return (NULL);						\
+	}								\
+	return (m);							\
+}									\
+									\
+static __inline__ void name##_delete(name##_t *m)			\
+{									\
+	if (m == NULL)							\
+		return;							\
+	free(m->ctrl);							\
+	free(m->slots);							\
+	free(m);							\
+}									\
+									\
+static __inline__ int name##_set(name##_t *m, key_type key, val_type val) \
+{									\
+	unsigned long int idx;						\
+	name##_slot_t s;						\
+									\
+	if (m == NULL)							\
+		return (0);						\
+	idx = name##_find(m, key, hash(key));				\
+	if (idx != m->size)						\
+	{								\
+		m->slots[idx].val = val;				\
+		return (1);						\
+	}								\
+	s.key = key;							\
+	s.val = val;							\
+	return (name##_insert(m, &s));					\
+}									\
+									\
+static __inline__ val_type *name##_get(const name##_t *m, key_type key) \
+{									\
+	unsigned long int idx;						\
+									\
+	if (m == NULL)							\
+		return (NULL);						\
+	idx = name##_find(m, key, hash(key));				\
+	return (idx != m->size ? &m->slots[idx].val : NULL);		\
+}									\
+									\
+static __inline__ int name##_remove(name##_t *m, key_type key)		\
+{									\
+	unsigned long int idx;						\
+									\
+	if (m == NULL)							\
+		return (0);						\
+	idx = name##_find(m, key, hash(key));				\
+	if (idx == m->size)						\
+		return (0);						\
+	name##_erase(m, idx);						\
+	return (1);							\
+}
+
+#endif /* HASH_MAP_H */
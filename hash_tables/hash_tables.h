@@ -4,41 +4,568 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
+
+/**
+ * hash_visit_t - Callback visiting the elements of a table
+ * @key: Key of the element
+ * @value: Value of the element
+ * @data: Data passed by the caller of the iteration
+ *
+ * Return: 0 to go on, anything else to stop the iteration
+ */
+typedef int (*hash_visit_t)(const char *key, const char *value, void *data);
+
+/* ==================== Hash Functions ==================== */
+
+/**
+ * struct hash_func_s - Hash function usable by a hash table
+ * @name: Short name of the function
+ * @hash: Hashes @len bytes of a key, perturbed by a seed
+ */
+typedef struct hash_func_s
+{
+	const char *name;
+	unsigned long int (*hash)(const void *key, size_t len,
+				  unsigned long int seed);
+} hash_func_t;
+
+extern const hash_func_t hash_func_djb2;
+extern const hash_func_t hash_func_xx;
+
+unsigned long int hash_djb2_seeded(const void *key, size_t len,
+				   unsigned long int seed);
+unsigned long int hash_xx(const void *key, size_t len, unsigned long int seed);
+unsigned long int hash_random_seed(void);
+
+/* ==================== Arena ==================== */
+
+/**
+ * struct hash_slab_s - Slab of an arena, its bytes follow the header
+ * @next: Pointer to the next slab
+ * @used: Number of bytes already handed out
+ * @size: Number of usable bytes
+ */
+typedef struct hash_slab_s
+{
+	struct hash_slab_s *next;
+	size_t used;
+	size_t size;
+} hash_slab_t;
+
+/**
+ * struct hash_arena_s - Bump allocator freed all at once
+ * @slabs: List of slabs, allocations are carved from the first one
+ * @slab_size: Usable size of each new slab
+ */
+typedef struct hash_arena_s
+{
+	hash_slab_t *slabs;
+	size_t slab_size;
+} hash_arena_t;
+
+/* Default slab size of an arena */
+#define HT_SLAB_SIZE (1UL << 20)
+
+hash_arena_t *hash_arena_create(size_t slab_size);
+void *hash_arena_alloc(hash_arena_t *a, size_t n, size_t align);
+void hash_arena_destroy(hash_arena_t *a);
+
+/* ==================== String Pool ==================== */
+
+/**
+ * struct str_pool_entry_s - String of a pool, its bytes follow the header
+ * @next: Pointer to the next entry of the bucket list
+ * @hash: hash_xx() of the string
+ * @len: Length of the string
+ * @refs: Number of references held on the string
+ */
+typedef struct str_pool_entry_s
+{
+	struct str_pool_entry_s *next;
+	unsigned long int hash;
+	size_t len;
+	unsigned long int refs;
+} str_pool_entry_t;
+
+/**
+ * struct str_pool_s - Pool of interned, reference-counted strings
+ * @size: Number of buckets (a power of two)
+ * @count: Number of distinct strings
+ * @array: Array of @size bucket lists
+ *
+ * Description: A pool may be shared by several hash tables and sorted
+ * hash tables, which then hold one copy of each distinct key.
+ */
+typedef struct str_pool_s
+{
+	unsigned long int size;
+	unsigned long int count;
+	str_pool_entry_t **array;
+} str_pool_t;
+
+str_pool_t *str_pool_create(unsigned long int size);
+const char *str_pool_intern(str_pool_t *p, const char *s, size_t len);
+const char *str_pool_find(const str_pool_t *p, const char *s, size_t len);
+void str_pool_release(str_pool_t *p, const char *s);
+void str_pool_delete(str_pool_t *p);
 
 /* ==================== Basic Hash Table ==================== */
 
 /**
  * struct hash_node_s - Node of a hash table
- * @key: The key, string (unique)
- * @value: The value corresponding to a key
  * @next: Pointer to the next node of the list (chaining)
+ * @hash: Full hash of the key, compared before the key itself
+ *        and reused when the table is rehashed
+ * @key_len: Length of the key
+ * @value_len: Length of the value
+ * @key: The key, a unique string in the hash table
+ * @value: The value corresponding to a key
+ *
+ * Description: @key points right behind the node, in the same block,
+ * or into the pool of a table that interns its keys; @value has a block
+ * of its own. Both are followed by a NUL byte. Nodes of an
+ * inline_strings table are hash_cnode_t instead: only the members up to
+ * @value_len exist, so read their strings with hash_node_key() and
+ * hash_node_value(), which work for every table.
  */
 typedef struct hash_node_s
 {
+	struct hash_node_s *next;
+	unsigned long int hash;
+	unsigned int key_len;
+	unsigned int value_len;
 	char *key;
 	char *value;
-	struct hash_node_s *next;
 } hash_node_t;
 
+/**
+ * struct hash_cnode_s - Compact node of an inline_strings table
+ * @next: Pointer to the next node of the list (chaining)
+ * @hash: Full hash of the key
+ * @key_len: Length of the key
+ * @value_len: Length of the value
+ *
+ * Description: The first members of hash_node_t, with no pointer; the
+ * strings follow in the same block: first a pointer to the value if it
+ * is stored on its own, then a pointer to the key if the table interns
+ * its keys, then the bytes of the key if it doesn't, then the bytes of
+ * the value if it is inline (see hash_node_value_inline()). Chains link
+ * them as hash_node_t, whose @key and @value they lack.
+ */
+typedef struct hash_cnode_s
+{
+	struct hash_node_s *next;
+	unsigned long int hash;
+	unsigned int key_len;
+	unsigned int value_len;
+} hash_cnode_t;
+
+/* Longest key or value a hash_node_t can hold */
+#define HT_LEN_MAX 0xffffffffUL
+
+/**
+ * struct hash_counters_s - Operation counters of a hash table
+ * @inserts: Number of keys added by hash_table_set()
+ * @updates: Number of values replaced by hash_table_set()
+ * @collisions: Number of keys added to a non-empty bucket
+ * @get_hits: Number of lookups that found their key
+ * @get_misses: Number of lookups that didn't
+ * @removes: Number of keys removed
+ */
+typedef struct hash_counters_s
+{
+	unsigned long int inserts;
+	unsigned long int updates;
+	unsigned long int collisions;
+	unsigned long int get_hits;
+	unsigned long int get_misses;
+	unsigned long int removes;
+} hash_counters_t;
+
+/* Maximum number of bits set per key by a Bloom filter */
+#define BLOOM_MAX_K 7
+
+/**
+ * struct hash_bloom_s - Blocked Bloom filter answering "absent" for a table
+ * @blocks: Array of @nblocks 64-byte blocks
+ * @nblocks: Number of blocks (a power of two)
+ * @bits_per_key: Bits per key the filter is sized with
+ * @k: Number of bits set per key
+ * @capacity: Number of keys the filter is sized for
+ * @keys: Number of keys added since the last rebuild
+ * @stale: Number of keys removed since the last rebuild
+ * @negatives: Lookups answered "absent" by the filter
+ * @positives: Lookups let through by the filter
+ * @false_positives: Lookups let through that missed anyway
+ */
+typedef struct hash_bloom_s
+{
+	unsigned long int *blocks;
+	unsigned long int nblocks;
+	unsigned int bits_per_key;
+	unsigned int k;
+	unsigned long int capacity;
+	unsigned long int keys;
+	unsigned long int stale;
+	unsigned long int negatives;
+	unsigned long int positives;
+	unsigned long int false_positives;
+} hash_bloom_t;
+
 /**
  * struct hash_table_s - Hash table data structure
  * @size: The size of the array
  * @array: Array of size @size (each cell points to a bucket list)
+ * @count: Number of elements stored in the table
+ * @old_size: The size of @old_array
+ * @old_array: Array being migrated into @array by a pending rehash,
+ *             or NULL if no rehash is in progress
+ * @rehash_pos: Index of the next @old_array bucket to migrate
+ * @incremental: Nonzero to spread a rehash over the following
+ *               hash_table_set() calls instead of doing it at once
+ * @hf: Hash function of the table
+ * @seed: Seed passed to @hf
+ * @index_mode: How hashes are reduced to indexes, see hash_index()
+ * @arena: Arena holding nodes, keys and values, or NULL if they are
+ *         allocated one by one with malloc()
+ * @inline_strings: Nonzero to store short values inline, in compact
+ *                  nodes (hash_cnode_t)
+ * @defer_free: Number of removed nodes kept before they are freed
+ *              together, or 0 to free them at once
+ * @removed: List of removed nodes not freed yet
+ * @removed_count: Number of nodes in @removed
+ * @counters: Operation counters, or NULL if they are not kept; being
+ *            pointed to, they are updated by lookups on a const table
+ * @pool: Pool the keys are interned in, or NULL if each node owns a
+ *        copy of its key
+ * @bloom: Filter consulted before the buckets, or NULL
  */
 typedef struct hash_table_s
 {
 	unsigned long int size;
 	hash_node_t **array;
+	unsigned long int count;
+	unsigned long int old_size;
+	hash_node_t **old_array;
+	unsigned long int rehash_pos;
+	int incremental;
+	const hash_func_t *hf;
+	unsigned long int seed;
+	int index_mode;
+	hash_arena_t *arena;
+	int inline_strings;
+	unsigned long int defer_free;
+	hash_node_t *removed;
+	unsigned long int removed_count;
+	hash_counters_t *counters;
+	str_pool_t *pool;
+	hash_bloom_t *bloom;
 } hash_table_t;
 
+/* Bumps an operation counter of a table that keeps them */
+#define HT_COUNT(ht, field) \
+	do { \
+		if ((ht)->counters != NULL) \
+			(ht)->counters->field++; \
+	} while (0)
+
+/* Values shorter than this are stored inline by inline_strings tables */
+#define HT_INLINE_MAX 24
+
+/**
+ * struct hash_opts_s - Options of hash_table_create_opts()
+ * @hf: Hash function (NULL for &hash_func_djb2)
+ * @seed: Seed passed to @hf, e.g. from hash_random_seed()
+ * @index_mode: HT_INDEX_MOD (0, default), HT_INDEX_MASK (size rounded up
+ *              to a power of two) or HT_INDEX_FASTRANGE
+ * @use_arena: Nonzero to bump-allocate nodes, keys and values from
+ *             an arena released only by hash_table_delete()
+ * @slab_size: Slab size of the arena (0 for HT_SLAB_SIZE)
+ * @inline_strings: Nonzero to use compact nodes (hash_cnode_t), which
+ *                  store values shorter than HT_INLINE_MAX in the same
+ *                  block as their node, as keys always are
+ * @counters: Nonzero to keep operation counters, see hash_table_stats()
+ * @pool: Pool to intern keys in (which must outlive the table), so that
+ *        keys are shared with other tables
+ * @incremental: Nonzero to spread each rehash over the following
+ *               operations instead of doing it at once
+ * @defer_free: Number of removed nodes kept before they are freed
+ *              together, or 0 to free them at once
+ */
+typedef struct hash_opts_s
+{
+	const hash_func_t *hf;
+	unsigned long int seed;
+	int index_mode;
+	int use_arena;
+	size_t slab_size;
+	int inline_strings;
+	int counters;
+	str_pool_t *pool;
+	int incremental;
+	unsigned long int defer_free;
+} hash_opts_t;
+
+/* Ways of reducing a hash to an index, see hash_index() */
+#define HT_INDEX_MOD 0
+#define HT_INDEX_MASK 1
+#define HT_INDEX_FASTRANGE 2
+
+/* Number of old buckets migrated per operation by an incremental rehash */
+#define HT_REHASH_STEP 4
+
+/**
+ * hash_mix - Finalizer spreading every bit of a hash over its low bits
+ * @h: Hash to mix
+ *
+ * Description: djb2 barely changes the low bits of a hash between keys
+ * differing in their last characters, and leaves short keys with empty
+ * high bits; masking or fastrange alone would cluster them.
+ * Defined here so that it inlines into every caller, DEFINE_HASHMAP maps
+ * included.
+ * Return: The mixed hash
+ */
+static __inline__ unsigned long int hash_mix(unsigned long int h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdUL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53UL;
+	h ^= h >> 33;
+	return (h);
+}
+
 /* Prototypes - basic hash table */
 hash_table_t *hash_table_create(unsigned long int size);
+hash_table_t *hash_table_create_opts(unsigned long int size,
+				     const hash_opts_t *opts);
+unsigned long int hash_table_hash(const hash_table_t *ht, const char *key,
+				  size_t len);
 unsigned long int hash_djb2(const unsigned char *str);
 unsigned long int key_index(const unsigned char *key, unsigned long int size);
+unsigned long int hash_index(unsigned long int hash, unsigned long int size,
+			     int mode);
 int hash_table_set(hash_table_t *ht, const char *key, const char *value);
+int hash_table_set_hashed(hash_table_t *ht, const char *key, size_t len,
+			  unsigned long int hash, const char *value,
+			  size_t vlen);
+int hash_table_set_bin(hash_table_t *ht, const void *key, size_t klen,
+		       const void *value, size_t vlen);
 char *hash_table_get(const hash_table_t *ht, const char *key);
+void *hash_table_get_bin(const hash_table_t *ht, const void *key,
+			 size_t klen, size_t *vlen);
 void hash_table_print(const hash_table_t *ht);
 void hash_table_delete(hash_table_t *ht);
+hash_node_t *hash_chain_find(const hash_table_t *ht, hash_node_t *node,
+			     const char *key, size_t len,
+			     unsigned long int hash);
+hash_node_t *hash_table_find(const hash_table_t *ht, const char *key,
+			     size_t len, unsigned long int hash);
+hash_node_t *hash_node_create(hash_table_t *ht, const char *key, size_t len,
+			      unsigned long int hash, const char *value,
+			      size_t vlen);
+int hash_node_set_value(hash_table_t *ht, hash_node_t **link,
+			const char *value, size_t vlen);
+void hash_node_free(const hash_table_t *ht, hash_node_t *node);
+int hash_node_value_inline(const hash_table_t *ht, size_t vlen);
+char *hash_node_key(const hash_table_t *ht, const hash_node_t *node);
+char *hash_node_value(const hash_table_t *ht, const hash_node_t *node);
+size_t hash_node_size(const hash_table_t *ht, const hash_node_t *node);
+
+/* Prototypes - Bloom filter */
+int hash_table_bloom_enable(hash_table_t *ht, unsigned int bits_per_key);
+double hash_table_bloom_fpr(const hash_table_t *ht, double *measured);
+void hash_bloom_add(hash_table_t *ht, unsigned long int hash);
+int hash_bloom_test(const hash_table_t *ht, unsigned long int hash);
+int hash_bloom_rebuild(hash_table_t *ht, unsigned long int capacity);
+
+/* Prototypes - removal */
+int hash_table_remove(hash_table_t *ht, const char *key);
+int hash_table_remove_bin(hash_table_t *ht, const void *key, size_t klen);
+void hash_table_flush_removed(hash_table_t *ht);
+
+/* Number of chain lengths told apart by hash_stats_t */
+#define HT_STATS_HIST 8
+
+/**
+ * struct hash_stats_s - Statistics of a hash table
+ * @size: Number of buckets
+ * @count: Number of elements
+ * @load_factor: @count / @size
+ * @used_buckets: Number of non-empty buckets
+ * @hist: @hist[i] is the number of buckets holding i elements, the last
+ *        entry counting the buckets holding HT_STATS_HIST - 1 or more
+ * @max_probe: Length of the longest chain
+ * @mean_probe: Mean number of nodes looked at to find a present key
+ * @memory: Bytes used by the table, its nodes, keys and values
+ *          (allocator overhead not included)
+ * @ops: Copy of the operation counters (zeroed if they aren't kept)
+ */
+typedef struct hash_stats_s
+{
+	unsigned long int size;
+	unsigned long int count;
+	double load_factor;
+	unsigned long int used_buckets;
+	unsigned long int hist[HT_STATS_HIST];
+	unsigned long int max_probe;
+	double mean_probe;
+	size_t memory;
+	hash_counters_t ops;
+} hash_stats_t;
+
+/* Prototypes - statistics */
+int hash_table_stats(const hash_table_t *ht, hash_stats_t *st);
+void hash_stats_print(const hash_stats_t *st);
+
+/* Prototypes - resizing */
+hash_node_t **hash_table_bucket(const hash_table_t *ht,
+				unsigned long int hash);
+void hash_table_rehash_step(hash_table_t *ht, unsigned long int n);
+int hash_table_grow(hash_table_t *ht);
+int hash_table_reserve(hash_table_t *ht, unsigned long int n);
+unsigned long int hash_pow2(unsigned long int n);
+
+/* Prototypes - batched operations */
+#define HT_BATCH 64
+size_t hash_table_set_batch(hash_table_t *ht, const char **keys,
+			    const char **values, size_t n);
+size_t hash_table_get_batch(const hash_table_t *ht, const char **keys,
+			    char **values, size_t n);
+
+/* ==================== Iteration and Dumps ==================== */
+
+/**
+ * struct hash_cursor_s - Position of a resumable scan of a hash table
+ * @pos: Next bucket to visit, see hash_table_scan() (0 before the scan)
+ *
+ * Description: Scans work on HT_INDEX_MOD and HT_INDEX_MASK tables,
+ * which only ever double (hash_table_reserve() rounds up by doubling);
+ * HT_INDEX_FASTRANGE tables have no resumable scan.
+ */
+typedef struct hash_cursor_s
+{
+	unsigned long int pos;
+} hash_cursor_t;
+
+/* Output formats of hash_table_dump() */
+#define HT_DUMP_DICT 0
+#define HT_DUMP_JSON 1
+#define HT_DUMP_CSV 2
+
+/* Prototypes - iteration and dumps */
+int hash_table_foreach(const hash_table_t *ht, hash_visit_t visit,
+		       void *data);
+int hash_table_scan(const hash_table_t *ht, hash_cursor_t *cur,
+		    hash_visit_t visit, void *data);
+long hash_table_dump(const hash_table_t *ht, int fd, int format);
+size_t hash_table_dump_buf(const hash_table_t *ht, char *buf, size_t size,
+			   int format);
+
+/* ==================== Snapshots ==================== */
+
+/**
+ * struct hash_snap_header_s - Header of a snapshot file
+ * @magic: "HTSNAP2"
+ * @length: Length of the whole file, so that a truncated one is rejected
+ * @hash_name: Name of the hash function of the table
+ * @seed: Seed of the hash function
+ * @index_mode: Index mode of the table, see hash_index()
+ * @size: Number of buckets
+ * @count: Number of elements
+ *
+ * Description: The header is followed by @size bucket offsets (0 for
+ * an empty bucket), then by the entries.
+ */
+typedef struct hash_snap_header_s
+{
+	char magic[8];
+	unsigned long int length;
+	char hash_name[16];
+	unsigned long int seed;
+	unsigned long int index_mode;
+	unsigned long int size;
+	unsigned long int count;
+} hash_snap_header_t;
+
+/**
+ * struct hash_snap_entry_s - Entry of a snapshot file
+ * @hash: Hash of the key
+ * @next: Offset of the next entry of the bucket, or 0
+ * @key_len: Length of the key
+ * @value_len: Length of the value
+ *
+ * Description: The entry is followed by the key and the value, each
+ * NUL-terminated, padded to a multiple of 8 bytes.
+ */
+typedef struct hash_snap_entry_s
+{
+	unsigned long int hash;
+	unsigned long int next;
+	unsigned long int key_len;
+	unsigned long int value_len;
+} hash_snap_entry_t;
+
+/**
+ * struct hash_snapshot_s - Snapshot file mapped in memory
+ * @base: Start of the mapping
+ * @len: Length of the mapping
+ * @header: Header of the snapshot
+ * @buckets: Bucket offsets of the snapshot
+ * @hf: Hash function named in the header
+ */
+typedef struct hash_snapshot_s
+{
+	void *base;
+	size_t len;
+	const hash_snap_header_t *header;
+	const unsigned long int *buckets;
+	const hash_func_t *hf;
+} hash_snapshot_t;
+
+/* Prototypes - snapshots */
+int hash_table_save(hash_table_t *ht, const char *filename);
+hash_snapshot_t *hash_table_load_mmap(const char *filename);
+const char *hash_snapshot_get(const hash_snapshot_t *s, const char *key);
+void hash_snapshot_close(hash_snapshot_t *s);
+
+/* ==================== Concurrent Hash Table ==================== */
+
+/**
+ * union cht_lock_u - Lock stripe padded to its own cache lines
+ * @lock: The lock
+ * @pad: Padding, so that stripes don't share cache lines
+ */
+typedef union cht_lock_u
+{
+	pthread_rwlock_t lock;
+	char pad[128];
+} cht_lock_t;
+
+/**
+ * struct chash_table_s - Hash table guarded by striped reader/writer locks
+ * @ht: Underlying hash table (HT_INDEX_MASK, at least @nlocks buckets)
+ * @locks: Array of @nlocks lock stripes
+ * @nlocks: Number of stripes (a power of two)
+ */
+typedef struct chash_table_s
+{
+	hash_table_t *ht;
+	cht_lock_t *locks;
+	unsigned long int nlocks;
+} chash_table_t;
+
+/* Default number of lock stripes of a concurrent hash table */
+#define CHT_DEFAULT_LOCKS 64
+
+/* Prototypes - concurrent hash table */
+chash_table_t *chash_table_create(unsigned long int size,
+				  unsigned long int nlocks);
+int chash_table_set(chash_table_t *cht, const char *key, const char *value);
+char *chash_table_get(chash_table_t *cht, const char *key);
+int chash_table_remove(chash_table_t *cht, const char *key);
+void chash_table_delete(chash_table_t *cht);
 
 /* ==================== Sorted Hash Table ==================== */
 
@@ -49,6 +576,9 @@ void hash_table_delete(hash_table_t *ht);
  * @next: Pointer to next node in same bucket (chaining)
  * @sprev: Pointer to previous element in the sorted linked list
  * @snext: Pointer to next element in the sorted linked list
+ * @slevel: Number of skip list levels the node is linked into
+ * @sfwd: Next node on each of the @slevel skip list levels
+ *        (the sorted linked list itself being level 0)
  */
 typedef struct shash_node_s
 {
@@ -57,14 +587,23 @@ typedef struct shash_node_s
 	struct shash_node_s *next;
 	struct shash_node_s *sprev;
 	struct shash_node_s *snext;
+	int slevel;
+	struct shash_node_s **sfwd;
 } shash_node_t;
 
+/* Maximum number of skip list levels above the sorted linked list */
+#define SHT_MAX_LEVEL 16
+
 /**
  * struct shash_table_s - Sorted hash table data structure
  * @size: The size of the array
  * @array: Array of size @size (each cell points to a bucket list)
  * @shead: Pointer to first element of the sorted linked list
  * @stail: Pointer to last element of the sorted linked list
+ * @sfwd: First node of each skip list level
+ * @slevel: Number of skip list levels in use
+ * @srand: State of the generator drawing node levels
+ * @pool: Pool the keys are interned in, or NULL (see shash_table_set_pool())
  */
 typedef struct shash_table_s
 {
@@ -72,6 +611,10 @@ typedef struct shash_table_s
 	shash_node_t **array;
 	shash_node_t *shead;
 	shash_node_t *stail;
+	shash_node_t *sfwd[SHT_MAX_LEVEL];
+	int slevel;
+	unsigned long int srand;
+	str_pool_t *pool;
 } shash_table_t;
 
 /* Prototypes - sorted hash table */
@@ -81,5 +624,78 @@ char *shash_table_get(const shash_table_t *ht, const char *key);
 void shash_table_print(const shash_table_t *ht);
 void shash_table_print_rev(const shash_table_t *ht);
 void shash_table_delete(shash_table_t *ht);
+int shash_table_set_pool(shash_table_t *ht, str_pool_t *pool);
+shash_node_t *shash_table_lower(const shash_table_t *ht, const char *key,
+				shash_node_t **preds);
+
+/**
+ * struct shash_cursor_s - Position in the key order of a sorted table
+ * @node: Element the cursor is on, or NULL if it is out of the table
+ *        (its key and value are read from there)
+ */
+typedef struct shash_cursor_s
+{
+	const shash_node_t *node;
+} shash_cursor_t;
+
+/* Prototypes - sorted hash table range queries and cursors */
+shash_node_t *shash_table_seek(const shash_table_t *ht, const char *key);
+unsigned long int shash_table_range(const shash_table_t *ht, const char *lo,
+				    const char *hi, hash_visit_t visit,
+				    void *data);
+unsigned long int shash_table_prefix(const shash_table_t *ht,
+				     const char *prefix, hash_visit_t visit,
+				     void *data);
+unsigned long int shash_table_range_rev(const shash_table_t *ht,
+					const char *lo, const char *hi,
+					hash_visit_t visit, void *data);
+int shash_cursor_seek(shash_cursor_t *cur, const shash_table_t *ht,
+		      const char *key);
+int shash_cursor_last(shash_cursor_t *cur, const shash_table_t *ht,
+		      const char *key);
+int shash_cursor_next(shash_cursor_t *cur);
+int shash_cursor_prev(shash_cursor_t *cur);
+
+/* ==================== Open-Addressing Hash Table ==================== */
+
+/**
+ * struct oa_slot_s - Slot of an open-addressing hash table
+ * @hash: Full hash of the key (compared before the key itself)
+ * @key: The key, string (unique)
+ * @value: The value corresponding to a key
+ */
+typedef struct oa_slot_s
+{
+	unsigned long int hash;
+	char *key;
+	char *value;
+} oa_slot_t;
+
+/**
+ * struct oa_hash_table_s - Robin Hood open-addressing hash table
+ * @size: Number of slots (always a power of two)
+ * @count: Number of stored elements
+ * @seed: Seed of the hash_xx() of the keys, from hash_random_seed()
+ * @ctrl: Control bytes, one per slot: 0 if empty,
+ *        otherwise the probe distance of the slot plus one
+ * @slots: Flat array of @size slots
+ */
+typedef struct oa_hash_table_s
+{
+	unsigned long int size;
+	unsigned long int count;
+	unsigned long int seed;
+	unsigned char *ctrl;
+	oa_slot_t *slots;
+} oa_hash_table_t;
+
+/* Prototypes - open-addressing hash table (same API as hash_table_t) */
+oa_hash_table_t *oa_hash_table_create(unsigned long int size);
+int oa_hash_table_set(oa_hash_table_t *ht, const char *key,
+		      const char *value);
+char *oa_hash_table_get(const oa_hash_table_t *ht, const char *key);
+void oa_hash_table_print(const oa_hash_table_t *ht);
+void oa_hash_table_delete(oa_hash_table_t *ht);
+int oa_hash_table_remove(oa_hash_table_t *ht, const char *key);
 
 #endif /* HASH_TABLES_H */